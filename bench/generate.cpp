@@ -0,0 +1,1045 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+// Writes a synthetic puzzle input for one day to stdout, so the solvers can be
+// run at sizes far beyond the real inputs.
+//   ./generate <day> <size> [seed] > input.txt
+// What <size> means differs per day (./generate with no arguments lists it).
+// The same day, size and seed always give the same bytes: the random numbers
+// come from mt19937_64 directly instead of the std distributions, whose
+// output differs between standard libraries.
+struct Rng {
+  std::mt19937_64 engine;
+  explicit Rng(uint64_t seed) : engine(seed) {}
+  // uniform in [lo, hi]
+  int64_t range(int64_t lo, int64_t hi) {
+    uint64_t span = (uint64_t)(hi - lo) + 1;
+    return lo + (int64_t)(engine() % span);
+  }
+  bool percent(int64_t p) { return range(0, 99) < p; }
+  char letter() { return (char)('a' + range(0, 25)); }
+  template <typename T>
+  void shuffle(std::vector<T> &v) {
+    for (size_t idx = v.size(); idx > 1; --idx) {
+      std::swap(v[idx - 1], v[(size_t)range(0, (int64_t)idx - 1)]);
+    }
+  }
+};
+
+struct Writer {
+  std::string buffer;
+  ~Writer() { flush(); }
+  void flush() {
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    buffer.clear();
+  }
+  Writer &operator<<(std::string_view s) {
+    buffer += s;
+    if (buffer.size() > (1 << 20)) {
+      flush();
+    }
+    return *this;
+  }
+  Writer &operator<<(char c) { return *this << std::string_view(&c, 1); }
+  Writer &operator<<(int64_t n) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), n);
+    return *this << std::string_view(digits, (size_t)(end - digits));
+  }
+  // right aligned in width columns, like the card numbers on day 4
+  Writer &padded(int64_t n, size_t width) {
+    std::string s = std::to_string(n);
+    if (s.length() < width) {
+      *this << std::string(width - s.length(), ' ');
+    }
+    return *this << s;
+  }
+};
+
+// count distinct lowercase names that are not in reserved, as short as still
+// leaves plenty of room to pick from
+std::vector<std::string> unique_names(Rng &rng, int64_t count,
+                                      const std::unordered_set<std::string> &reserved) {
+  size_t length = 2;
+  for (int64_t room = 26 * 26; room < count * 4; room *= 26) {
+    ++length;
+  }
+  std::unordered_set<std::string> seen(reserved);
+  std::vector<std::string> names;
+  while ((int64_t)names.size() < count) {
+    std::string name;
+    for (size_t idx = 0; idx < length; ++idx) {
+      name += rng.letter();
+    }
+    if (seen.insert(name).second) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+void grid(Rng &rng, int64_t side, std::string_view weighted_chars, Writer &out) {
+  for (int64_t row = 0; row < side; ++row) {
+    for (int64_t col = 0; col < side; ++col) {
+      out << weighted_chars[(size_t)rng.range(0, (int64_t)weighted_chars.length() - 1)];
+    }
+    out << '\n';
+  }
+}
+
+void day1(Rng &rng, int64_t size, Writer &out) {
+  const char *names[9] = {"one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+  for (int64_t line = 0; line < size; ++line) {
+    int64_t tokens = rng.range(3, 14);
+    int64_t forced_digit = rng.range(0, tokens - 1);
+    for (int64_t token = 0; token < tokens; ++token) {
+      int64_t kind = rng.range(0, 9);
+      if (token == forced_digit || kind < 3) {
+        out << (char)('1' + rng.range(0, 8));
+      } else if (kind < 5) {
+        out << names[rng.range(0, 8)];
+      } else {
+        out << rng.letter();
+      }
+    }
+    out << '\n';
+  }
+}
+
+void day2(Rng &rng, int64_t size, Writer &out) {
+  const char *colors[3] = {"red", "green", "blue"};
+  for (int64_t game = 1; game <= size; ++game) {
+    out << "Game " << game << ": ";
+    int64_t sets = rng.range(1, 6);
+    for (int64_t set = 0; set < sets; ++set) {
+      std::vector<int64_t> shown = {0, 1, 2};
+      rng.shuffle(shown);
+      shown.resize((size_t)rng.range(1, 3));
+      for (size_t idx = 0; idx < shown.size(); ++idx) {
+        out << (idx == 0 ? "" : ", ") << rng.range(1, 20) << ' ' << colors[shown[idx]];
+      }
+      out << (set + 1 == sets ? "\n" : "; ");
+    }
+  }
+}
+
+void day3(Rng &rng, int64_t size, Writer &out) {
+  const std::string_view symbols = "*#+$/@%=&-";
+  for (int64_t row = 0; row < size; ++row) {
+    for (int64_t col = 0; col < size;) {
+      int64_t roll = rng.range(0, 99);
+      if (roll < 8 && col + 3 < size) {
+        int64_t digits = rng.range(1, 3);
+        out << rng.range(digits == 1 ? 0 : (digits == 2 ? 10 : 100),
+                         digits == 1 ? 9 : (digits == 2 ? 99 : 999));
+        // numbers must not run into the next one
+        out << '.';
+        col += digits + 1;
+      } else {
+        out << (roll < 14 ? symbols[(size_t)rng.range(0, (int64_t)symbols.length() - 1)] : '.');
+        ++col;
+      }
+    }
+    out << '\n';
+  }
+}
+
+void day4(Rng &rng, int64_t size, Writer &out) {
+  size_t width = std::to_string(size).length();
+  for (int64_t card = 1; card <= size; ++card) {
+    std::vector<int64_t> pool(99);
+    std::iota(pool.begin(), pool.end(), 1);
+    rng.shuffle(pool);
+    // keep the expected matches below one so the copies in part 2 stay finite
+    int64_t matches = rng.percent(80) ? 0 : rng.range(1, 5);
+    matches = std::min(matches, size - card);
+    std::vector<int64_t> holding(pool.begin(), pool.begin() + matches);
+    holding.insert(holding.end(), pool.begin() + 10, pool.begin() + 35 - matches);
+    rng.shuffle(holding);
+    out << "Card ";
+    out.padded(card, width) << ':';
+    for (size_t idx = 0; idx < 10; ++idx) {
+      out << ' ';
+      out.padded(pool[idx], 2);
+    }
+    out << " |";
+    for (int64_t n : holding) {
+      out << ' ';
+      out.padded(n, 2);
+    }
+    out << '\n';
+  }
+}
+
+void day5(Rng &rng, int64_t size, Writer &out) {
+  const int64_t LIMIT = (int64_t)1 << 32;
+  out << "seeds:";
+  for (int64_t pair = 0; pair < size; ++pair) {
+    int64_t length = rng.range(1, std::max<int64_t>(1, LIMIT / (4 * size)));
+    out << ' ' << rng.range(0, LIMIT - length) << ' ' << length;
+  }
+  out << '\n';
+  const char *names[7] = {"seed-to-soil", "soil-to-fertilizer", "fertilizer-to-water",
+                          "water-to-light", "light-to-temperature", "temperature-to-humidity",
+                          "humidity-to-location"};
+  for (const char *name : names) {
+    // cut [0, 2^32) into size pieces and lay them out again in shuffled order,
+    // so every map is a bijection like the real ones
+    std::vector<int64_t> cuts;
+    while ((int64_t)cuts.size() < size - 1) {
+      cuts.push_back(rng.range(1, LIMIT - 1));
+      if ((int64_t)cuts.size() == size - 1) {
+        std::sort(cuts.begin(), cuts.end());
+        cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+      }
+    }
+    cuts.insert(cuts.begin(), 0);
+    cuts.push_back(LIMIT);
+    std::vector<size_t> order(cuts.size() - 1);
+    std::iota(order.begin(), order.end(), 0);
+    rng.shuffle(order);
+    std::vector<std::array<int64_t, 3>> entries;
+    int64_t destination = 0;
+    for (size_t piece : order) {
+      int64_t length = cuts[piece + 1] - cuts[piece];
+      entries.push_back({destination, cuts[piece], length});
+      destination += length;
+    }
+    rng.shuffle(entries);
+    out << '\n' << name << " map:\n";
+    for (const auto &[dst, src, length] : entries) {
+      out << dst << ' ' << src << ' ' << length << '\n';
+    }
+  }
+}
+
+void day6(Rng &rng, int64_t size, Writer &out) {
+  // two digit times starting at 5 and three digit distances keep the kerned
+  // race of part 2 winnable no matter how many races there are
+  std::vector<int64_t> times;
+  std::vector<int64_t> distances;
+  for (int64_t race = 0; race < size; ++race) {
+    int64_t time = rng.range(50, 99);
+    times.push_back(time);
+    distances.push_back(rng.range(100, std::min<int64_t>(999, time * time / 4 - 1)));
+  }
+  out << "Time:     ";
+  for (int64_t t : times) {
+    out << "  ";
+    out.padded(t, 3);
+  }
+  out << "\nDistance: ";
+  for (int64_t d : distances) {
+    out << "  ";
+    out.padded(d, 3);
+  }
+  out << '\n';
+}
+
+void day7(Rng &rng, int64_t size, Writer &out) {
+  const std::string_view cards = "23456789TJQKA";
+  const int64_t HANDS = 13 * 13 * 13 * 13 * 13;
+  // real inputs never repeat a hand, and a repeat would make the answer
+  // depend on how equal hands are ordered, so there are at most HANDS; the
+  // redraws stay cheap even then, about HANDS * ln(HANDS) in all
+  std::vector<bool> used(HANDS, false);
+  for (int64_t hand = 0; hand < std::min(size, HANDS); ++hand) {
+    int64_t code = rng.range(0, HANDS - 1);
+    while (used[(size_t)code]) {
+      code = rng.range(0, HANDS - 1);
+    }
+    used[(size_t)code] = true;
+    for (int64_t idx = 0; idx < 5; ++idx) {
+      out << cards[(size_t)(code % 13)];
+      code /= 13;
+    }
+    out << ' ' << rng.range(1, 1000) << '\n';
+  }
+}
+
+void day8(Rng &rng, int64_t size, Writer &out) {
+  // Every ghost walks a ring of directions.length() * p distinct nodes, where
+  // only the side taken at that step leads on. Its Z node has the same exits as
+  // its A node, so each ghost is periodic and part 2 is an lcm.
+  const int64_t ROOM = 26 * 26 * 24;
+  int64_t length = std::clamp<int64_t>(size, 1, ROOM);
+  const std::vector<int64_t> primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+  std::vector<int64_t> periods;
+  for (int64_t ghosts = 6; ghosts >= 1 && periods.empty(); --ghosts) {
+    std::vector<int64_t> fits;
+    for (int64_t p : primes) {
+      if (length * p * ghosts <= ROOM) {
+        fits.push_back(p);
+      }
+    }
+    if ((int64_t)fits.size() >= ghosts) {
+      rng.shuffle(fits);
+      periods.assign(fits.begin(), fits.begin() + ghosts);
+    }
+  }
+  if (periods.empty()) {
+    periods.push_back(1);
+  }
+  std::string directions;
+  for (int64_t idx = 0; idx < length; ++idx) {
+    directions += rng.percent(50) ? 'L' : 'R';
+  }
+
+  std::unordered_set<std::string> used = {"AAA", "ZZZ"};
+  // the last letter is drawn from the given ones, start and end nodes get A / Z
+  auto name_ending = [&rng, &used](std::string_view last) {
+    std::string name;
+    do {
+      name = {(char)('A' + rng.range(0, 25)), (char)('A' + rng.range(0, 25)),
+              last[(size_t)rng.range(0, (int64_t)last.length() - 1)]};
+    } while (!used.insert(name).second);
+    return name;
+  };
+  std::vector<std::string> lines;
+  for (size_t ghost = 0; ghost < periods.size(); ++ghost) {
+    int64_t ring = length * periods[ghost];
+    std::vector<std::string> nodes = {ghost == 0 ? "AAA" : name_ending("A")};
+    for (int64_t idx = 1; idx < ring; ++idx) {
+      nodes.push_back(name_ending("BCDEFGHIJKLMNOPQRSTUVWXY"));
+    }
+    std::string z = ghost == 0 ? "ZZZ" : name_ending("Z");
+    nodes.push_back(z);
+    std::vector<std::pair<std::string, std::string>> exits(nodes.size());
+    for (int64_t idx = 0; idx < ring; ++idx) {
+      const std::string &next = nodes[(size_t)idx + 1];
+      const std::string &decoy = nodes[(size_t)rng.range(1, ring)];
+      exits[(size_t)idx] = directions[(size_t)(idx % length)] == 'L'
+                               ? std::pair{next, decoy}
+                               : std::pair{decoy, next};
+    }
+    exits.back() = exits.front();
+    for (size_t idx = 0; idx < nodes.size(); ++idx) {
+      lines.push_back(nodes[idx] + " = (" + exits[idx].first + ", " + exits[idx].second + ")");
+    }
+  }
+  rng.shuffle(lines);
+  out << directions << "\n\n";
+  for (const std::string &line : lines) {
+    out << line << '\n';
+  }
+}
+
+void day9(Rng &rng, int64_t size, Writer &out) {
+  for (int64_t line = 0; line < size; ++line) {
+    // newton form: the k-th coefficient is the constant k-th difference
+    std::vector<int64_t> differences((size_t)rng.range(1, 7));
+    for (int64_t &d : differences) {
+      d = rng.range(-9, 9);
+    }
+    for (int64_t x = 0; x < 21; ++x) {
+      int64_t value = 0;
+      int64_t binomial = 1;
+      for (int64_t k = 0; k < (int64_t)differences.size(); ++k) {
+        value += differences[(size_t)k] * binomial;
+        binomial = binomial * (x - k) / (k + 1);
+      }
+      out << (x == 0 ? "" : " ") << value;
+    }
+    out << '\n';
+  }
+}
+
+void day10(Rng &rng, int64_t size, Writer &out) {
+  // The loop is the outline of a random spanning tree of a nodes x nodes grid,
+  // drawn two cells thick so it encloses tiles. A tree has no holes and its
+  // cells never touch only at a corner, so the outline is one simple cycle.
+  int64_t side = std::max<int64_t>(size, 3);
+  int64_t nodes = (side + 1) / 4;
+  int64_t tree_side = 2 * nodes - 1;
+  std::vector<bool> tree((size_t)(tree_side * tree_side), false);
+  std::vector<std::pair<int64_t, int64_t>> stack = {{0, 0}};
+  tree[0] = true;
+  while (!stack.empty()) {
+    auto [r, c] = stack.back();
+    std::vector<std::pair<int64_t, int64_t>> next;
+    for (auto [dr, dc] : {std::pair{0, 1}, {1, 0}, {0, -1}, {-1, 0}}) {
+      int64_t nr = r + 2 * dr;
+      int64_t nc = c + 2 * dc;
+      if (nr >= 0 && nr < tree_side && nc >= 0 && nc < tree_side &&
+          !tree[(size_t)(nr * tree_side + nc)]) {
+        next.push_back({nr, nc});
+      }
+    }
+    if (next.empty()) {
+      stack.pop_back();
+      continue;
+    }
+    auto [nr, nc] = next[(size_t)rng.range(0, (int64_t)next.size() - 1)];
+    tree[(size_t)(((r + nr) / 2) * tree_side + (c + nc) / 2)] = true;
+    tree[(size_t)(nr * tree_side + nc)] = true;
+    stack.push_back({nr, nc});
+  }
+  int64_t cells = 2 * tree_side;
+  auto filled = [&](int64_t x, int64_t y) {
+    return x >= 0 && y >= 0 && x < cells && y < cells &&
+           tree[(size_t)((y / 2) * tree_side + x / 2)];
+  };
+  // tiles sit on the corners of the cells
+  std::vector<std::string> tiles((size_t)side, std::string((size_t)side, '.'));
+  std::vector<std::pair<int64_t, int64_t>> loop;
+  for (int64_t y = 0; y < side; ++y) {
+    for (int64_t x = 0; x < side; ++x) {
+      bool north = filled(x - 1, y - 1) != filled(x, y - 1);
+      bool south = filled(x - 1, y) != filled(x, y);
+      bool west = filled(x - 1, y - 1) != filled(x - 1, y);
+      bool east = filled(x, y - 1) != filled(x, y);
+      char &tile = tiles[(size_t)y][(size_t)x];
+      if (north && south) {
+        tile = '|';
+      } else if (east && west) {
+        tile = '-';
+      } else if (north && east) {
+        tile = 'L';
+      } else if (north && west) {
+        tile = 'J';
+      } else if (south && west) {
+        tile = '7';
+      } else if (south && east) {
+        tile = 'F';
+      } else {
+        tile = "|-LJ7F....."[(size_t)rng.range(0, 10)];
+        continue;
+      }
+      loop.push_back({y, x});
+    }
+  }
+  auto [sy, sx] = loop[(size_t)rng.range(0, (int64_t)loop.size() - 1)];
+  tiles[(size_t)sy][(size_t)sx] = 'S';
+  // junk pipes next to S must not look like they connect to it
+  for (auto [dy, dx] : {std::pair{0, 1}, {1, 0}, {0, -1}, {-1, 0}}) {
+    int64_t y = sy + dy;
+    int64_t x = sx + dx;
+    if (y >= 0 && y < side && x >= 0 && x < side &&
+        !std::binary_search(loop.begin(), loop.end(), std::pair{y, x})) {
+      tiles[(size_t)y][(size_t)x] = '.';
+    }
+  }
+  for (const std::string &row : tiles) {
+    out << row << '\n';
+  }
+}
+
+void day11(Rng &rng, int64_t size, Writer &out) {
+  std::vector<bool> empty_row((size_t)size);
+  std::vector<bool> empty_col((size_t)size);
+  for (int64_t idx = 0; idx < size; ++idx) {
+    empty_row[(size_t)idx] = rng.percent(5);
+    empty_col[(size_t)idx] = rng.percent(5);
+  }
+  for (int64_t row = 0; row < size; ++row) {
+    for (int64_t col = 0; col < size; ++col) {
+      bool galaxy = !empty_row[(size_t)row] && !empty_col[(size_t)col] && rng.percent(1);
+      out << (galaxy ? '#' : '.');
+    }
+    out << '\n';
+  }
+}
+
+void day12(Rng &rng, int64_t size, Writer &out) {
+  for (int64_t line = 0; line < size; ++line) {
+    std::string springs((size_t)rng.range(6, 20), '.');
+    std::vector<int64_t> groups;
+    for (size_t idx = (size_t)rng.range(0, 2); idx < springs.length();) {
+      int64_t group = std::min<int64_t>(rng.range(1, 5), (int64_t)(springs.length() - idx));
+      std::fill_n(springs.begin() + (int64_t)idx, group, '#');
+      groups.push_back(group);
+      idx += (size_t)(group + rng.range(1, 4));
+    }
+    for (char &c : springs) {
+      if (rng.percent(50)) {
+        c = '?';
+      }
+    }
+    out << springs << ' ';
+    for (size_t idx = 0; idx < groups.size(); ++idx) {
+      out << (idx == 0 ? "" : ",") << groups[idx];
+    }
+    out << '\n';
+  }
+}
+
+void day13(Rng &rng, int64_t size, Writer &out) {
+  // Each pattern mirrors exactly about one column line and is off by exactly
+  // one cell about one row line, and every other line is off by two or more,
+  // so both parts have a single answer. The smudge sits in a column the column
+  // mirror leaves alone, so fixing it keeps that mirror intact.
+  for (int64_t pattern = 0; pattern < size; ++pattern) {
+    std::vector<std::string> rows;
+    while (true) {
+      int64_t height = 2 * rng.range(2, 8) + 1;
+      int64_t width = 2 * rng.range(2, 8) + 1;
+      int64_t v = rng.range(1, width - 1);
+      int64_t h = rng.range(1, height - 1);
+      std::vector<int64_t> parent((size_t)(height * width));
+      std::iota(parent.begin(), parent.end(), 0);
+      auto find = [&parent](int64_t x) {
+        while (parent[(size_t)x] != x) {
+          x = parent[(size_t)x] = parent[(size_t)parent[(size_t)x]];
+        }
+        return x;
+      };
+      std::vector<int64_t> free_cols;
+      for (int64_t c = 0; c < width; ++c) {
+        int64_t mirrored = 2 * v - 1 - c;
+        if (mirrored < 0 || mirrored >= width) {
+          free_cols.push_back(c);
+        }
+      }
+      int64_t smudge_col = free_cols[(size_t)rng.range(0, (int64_t)free_cols.size() - 1)];
+      int64_t smudge_row = rng.range(std::max<int64_t>(0, 2 * h - height), h - 1);
+      for (int64_t r = 0; r < height; ++r) {
+        for (int64_t c = 0; c < width; ++c) {
+          int64_t mc = 2 * v - 1 - c;
+          if (mc >= 0 && mc < width) {
+            parent[(size_t)find(r * width + c)] = find(r * width + mc);
+          }
+          int64_t mr = 2 * h - 1 - r;
+          if (mr >= 0 && mr < height && !(c == smudge_col && (r == smudge_row || mr == smudge_row))) {
+            parent[(size_t)find(r * width + c)] = find(mr * width + c);
+          }
+        }
+      }
+      std::vector<char> value((size_t)(height * width));
+      for (char &c : value) {
+        c = rng.percent(50) ? '#' : '.';
+      }
+      rows.assign((size_t)height, std::string((size_t)width, '.'));
+      for (int64_t r = 0; r < height; ++r) {
+        for (int64_t c = 0; c < width; ++c) {
+          rows[(size_t)r][(size_t)c] = value[(size_t)find(r * width + c)];
+        }
+      }
+      char &smudge = rows[(size_t)smudge_row][(size_t)smudge_col];
+      smudge = rows[(size_t)(2 * h - 1 - smudge_row)][(size_t)smudge_col] == '#' ? '.' : '#';
+
+      auto column_errors = [&](int64_t line) {
+        int64_t errors = 0;
+        for (int64_t c = 0; line - 1 - c >= 0 && line + c < width; ++c) {
+          for (int64_t r = 0; r < height; ++r) {
+            errors += rows[(size_t)r][(size_t)(line - 1 - c)] != rows[(size_t)r][(size_t)(line + c)];
+          }
+        }
+        return errors;
+      };
+      auto row_errors = [&](int64_t line) {
+        int64_t errors = 0;
+        for (int64_t r = 0; line - 1 - r >= 0 && line + r < height; ++r) {
+          for (int64_t c = 0; c < width; ++c) {
+            errors += rows[(size_t)(line - 1 - r)][(size_t)c] != rows[(size_t)(line + r)][(size_t)c];
+          }
+        }
+        return errors;
+      };
+      bool unique = true;
+      for (int64_t line = 1; line < width; ++line) {
+        unique = unique && (line == v ? column_errors(line) == 0 : column_errors(line) >= 2);
+      }
+      for (int64_t line = 1; line < height; ++line) {
+        unique = unique && (line == h ? row_errors(line) == 1 : row_errors(line) >= 2);
+      }
+      if (unique) {
+        break;
+      }
+    }
+    if (rng.percent(50)) {
+      std::vector<std::string> transposed(rows[0].length(), std::string(rows.size(), '.'));
+      for (size_t r = 0; r < rows.size(); ++r) {
+        for (size_t c = 0; c < rows[0].length(); ++c) {
+          transposed[c][r] = rows[r][c];
+        }
+      }
+      rows = transposed;
+    }
+    out << (pattern == 0 ? "" : "\n");
+    for (const std::string &row : rows) {
+      out << row << '\n';
+    }
+  }
+}
+
+void day14(Rng &rng, int64_t size, Writer &out) { grid(rng, size, "OO##......", out); }
+
+void day15(Rng &rng, int64_t size, Writer &out) {
+  std::vector<std::string> labels((size_t)std::max<int64_t>(8, size / 8));
+  for (std::string &label : labels) {
+    for (int64_t idx = rng.range(2, 6); idx > 0; --idx) {
+      label += rng.letter();
+    }
+  }
+  for (int64_t step = 0; step < size; ++step) {
+    out << (step == 0 ? "" : ",") << labels[(size_t)rng.range(0, (int64_t)labels.size() - 1)];
+    if (rng.percent(70)) {
+      out << '=' << rng.range(1, 9);
+    } else {
+      out << '-';
+    }
+  }
+  out << '\n';
+}
+
+void day16(Rng &rng, int64_t size, Writer &out) {
+  grid(rng, size, "/\\|-................................", out);
+}
+
+void day17(Rng &rng, int64_t size, Writer &out) { grid(rng, size, "123456789", out); }
+
+// A closed dig plan that alternates horizontal and vertical edges: a run of
+// columns above y = 0 and another below it, so it never crosses itself.
+std::vector<std::pair<char, int64_t>> dig_loop(Rng &rng, int64_t edges, int64_t max_width,
+                                               int64_t max_height) {
+  int64_t top_columns = (edges / 2 + 1) / 2;
+  int64_t bottom_columns = edges / 2 - top_columns;
+  auto profile = [&](int64_t columns) {
+    std::vector<std::pair<int64_t, int64_t>> widths_heights;
+    for (int64_t idx = 0; idx < columns; ++idx) {
+      int64_t height = rng.range(1, max_height);
+      while (idx > 0 && height == widths_heights.back().second) {
+        height = rng.range(1, max_height);
+      }
+      widths_heights.push_back({rng.range(1, max_width), height});
+    }
+    return widths_heights;
+  };
+  auto top = profile(top_columns);
+  auto bottom = profile(bottom_columns);
+  int64_t top_width = 0;
+  int64_t bottom_width = 0;
+  for (auto [w, h] : top) {
+    top_width += w;
+  }
+  for (auto [w, h] : bottom) {
+    bottom_width += w;
+  }
+  (top_width < bottom_width ? top : bottom).back().first += std::abs(top_width - bottom_width);
+
+  std::vector<std::pair<char, int64_t>> plan = {{'U', bottom.front().second + top.front().second}};
+  for (size_t idx = 0; idx < top.size(); ++idx) {
+    plan.push_back({'R', top[idx].first});
+    if (idx + 1 < top.size()) {
+      int64_t rise = top[idx + 1].second - top[idx].second;
+      plan.push_back({rise > 0 ? 'U' : 'D', std::abs(rise)});
+    }
+  }
+  plan.push_back({'D', top.back().second + bottom.back().second});
+  for (size_t idx = bottom.size(); idx-- > 0;) {
+    plan.push_back({'L', bottom[idx].first});
+    if (idx > 0) {
+      int64_t drop = bottom[idx - 1].second - bottom[idx].second;
+      plan.push_back({drop > 0 ? 'D' : 'U', std::abs(drop)});
+    }
+  }
+  std::rotate(plan.begin(), plan.begin() + rng.range(0, (int64_t)plan.size() - 1), plan.end());
+  return plan;
+}
+
+void day18(Rng &rng, int64_t size, Writer &out) {
+  int64_t edges = std::max<int64_t>(4, size + size % 2);
+  auto part1 = dig_loop(rng, edges, 6, 12);
+  // the hex codes hold five digit lengths
+  auto part2 = dig_loop(rng, edges, 100'000, 500'000);
+  for (size_t idx = 0; idx < part1.size(); ++idx) {
+    char hex[16];
+    std::snprintf(hex, sizeof(hex), "%05llx", (unsigned long long)part2[idx].second);
+    int64_t direction = std::string_view("RDLU").find(part2[idx].first);
+    out << part1[idx].first << ' ' << part1[idx].second << " (#" << hex << direction << ")\n";
+  }
+}
+
+void day19(Rng &rng, int64_t size, Writer &out) {
+  // The workflows form a tree under "in", like the real input: each one is
+  // the target of exactly one rule, so every part ends in A or R. Every rule
+  // splits the ratings that actually reach it, so no branch is dead.
+  int64_t count = std::max<int64_t>(size, 1);
+  std::vector<std::string> names = unique_names(rng, count - 1, {"in"});
+  names.insert(names.begin(), "in");
+  struct Rule {
+    char category;
+    char compare;
+    int64_t value;
+    std::string target;
+  };
+  // inclusive x, m, a, s ranges
+  using Box = std::array<std::pair<int64_t, int64_t>, 4>;
+  struct Target {
+    size_t workflow;
+    size_t rule;
+    Box box;
+  };
+  std::vector<std::vector<Rule>> workflows((size_t)count);
+  std::vector<Target> open_targets;
+  Box box = {{{1, 4000}, {1, 4000}, {1, 4000}, {1, 4000}}};
+  for (size_t idx = 0; idx < (size_t)count; ++idx) {
+    if (idx > 0) {
+      size_t pick = (size_t)rng.range(0, (int64_t)open_targets.size() - 1);
+      Target target = open_targets[pick];
+      workflows[target.workflow][target.rule].target = names[idx];
+      box = target.box;
+      open_targets[pick] = open_targets.back();
+      open_targets.pop_back();
+    }
+    for (int64_t rules = rng.range(1, 3); rules > 0; --rules) {
+      size_t category = (size_t)rng.range(0, 3);
+      auto [lo, hi] = box[category];
+      if (lo == hi) {
+        break;
+      }
+      Box matched = box;
+      Rule rule{.category = "xmas"[category], .compare = '<', .value = 0, .target = "R"};
+      if (rng.percent(50)) {
+        rule.value = rng.range(lo + 1, hi);
+        matched[category].second = rule.value - 1;
+        box[category].first = rule.value;
+      } else {
+        rule.compare = '>';
+        rule.value = rng.range(lo, hi - 1);
+        matched[category].first = rule.value + 1;
+        box[category].second = rule.value;
+      }
+      rule.target = rng.percent(50) ? "A" : "R";
+      workflows[idx].push_back(rule);
+      open_targets.push_back({idx, workflows[idx].size() - 1, matched});
+    }
+    workflows[idx].push_back(Rule{.category = 'x', .compare = '<', .value = 0,
+                                  .target = rng.percent(50) ? "A" : "R"});
+    open_targets.push_back({idx, workflows[idx].size() - 1, box});
+  }
+  std::vector<size_t> order((size_t)count);
+  std::iota(order.begin(), order.end(), 0);
+  rng.shuffle(order);
+  for (size_t idx : order) {
+    out << names[idx] << '{';
+    const std::vector<Rule> &rules = workflows[idx];
+    for (size_t rule = 0; rule + 1 < rules.size(); ++rule) {
+      out << rules[rule].category << rules[rule].compare << rules[rule].value << ':'
+          << rules[rule].target << ',';
+    }
+    out << rules.back().target << "}\n";
+  }
+  out << '\n';
+  for (int64_t part = 0; part < size; ++part) {
+    out << "{x=" << rng.range(1, 4000) << ",m=" << rng.range(1, 4000)
+        << ",a=" << rng.range(1, 4000) << ",s=" << rng.range(1, 4000) << "}\n";
+  }
+}
+
+void day20(Rng &rng, int64_t size, Writer &out) {
+  // The real circuit: the broadcaster drives size 12 bit counters. Each
+  // counter's conjunction fires and resets it every p presses, for a prime p,
+  // and rx only sees a low pulse once all of them fire on the same press.
+  const int64_t BITS = 12;
+  int64_t counters = std::max<int64_t>(size, 1);
+  std::vector<std::string> names = unique_names(rng, counters * (BITS + 2) + 1, {"rx"});
+  const std::string &last = names.back();
+  std::vector<int64_t> periods;
+  while ((int64_t)periods.size() < counters) {
+    int64_t p = rng.range(1 << (BITS - 1), (1 << BITS) - 1) | 1;
+    bool prime = true;
+    for (int64_t d = 3; d * d <= p; d += 2) {
+      prime = prime && p % d != 0;
+    }
+    if (prime && std::find(periods.begin(), periods.end(), p) == periods.end()) {
+      periods.push_back(p);
+    }
+  }
+  std::vector<std::string> lines;
+  std::vector<std::string> firsts;
+  for (int64_t counter = 0; counter < counters; ++counter) {
+    const std::string *bits = &names[(size_t)(counter * (BITS + 2))];
+    const std::string &hub = bits[BITS];
+    const std::string &inverter = bits[BITS + 1];
+    firsts.push_back(bits[0]);
+    std::vector<std::string> hub_outputs = {bits[0]};
+    for (int64_t bit = 0; bit < BITS; ++bit) {
+      std::vector<std::string> outputs;
+      if (bit + 1 < BITS) {
+        outputs.push_back(bits[bit + 1]);
+      }
+      if (periods[(size_t)counter] >> bit & 1) {
+        outputs.push_back(hub);
+      } else {
+        hub_outputs.push_back(bits[bit]);
+      }
+      rng.shuffle(outputs);
+      std::string line = "%" + bits[bit] + " ->";
+      for (size_t idx = 0; idx < outputs.size(); ++idx) {
+        line += (idx == 0 ? " " : ", ") + outputs[idx];
+      }
+      lines.push_back(line);
+    }
+    hub_outputs.push_back(inverter);
+    rng.shuffle(hub_outputs);
+    std::string line = "&" + hub + " ->";
+    for (size_t idx = 0; idx < hub_outputs.size(); ++idx) {
+      line += (idx == 0 ? " " : ", ") + hub_outputs[idx];
+    }
+    lines.push_back(line);
+    lines.push_back("&" + inverter + " -> " + last);
+  }
+  lines.push_back("&" + last + " -> rx");
+  std::string broadcaster = "broadcaster ->";
+  for (size_t idx = 0; idx < firsts.size(); ++idx) {
+    broadcaster += (idx == 0 ? " " : ", ") + firsts[idx];
+  }
+  lines.push_back(broadcaster);
+  rng.shuffle(lines);
+  for (const std::string &line : lines) {
+    out << line << '\n';
+  }
+}
+
+void day21(Rng &rng, int64_t size, Writer &out) {
+  // like the real garden: odd side, S in the middle, and its row, its column,
+  // the border and the diamond halfway out all free of rocks
+  int64_t side = std::max<int64_t>(5, size - (size + 1) % 2);
+  int64_t mid = side / 2;
+  for (int64_t row = 0; row < side; ++row) {
+    for (int64_t col = 0; col < side; ++col) {
+      int64_t diamond = std::abs(row - mid) + std::abs(col - mid);
+      bool clear = row == mid || col == mid || row == 0 || col == 0 || row == side - 1 ||
+                   col == side - 1 || std::abs(diamond - mid) <= 1;
+      out << (row == mid && col == mid ? 'S' : (!clear && rng.percent(12) ? '#' : '.'));
+    }
+    out << '\n';
+  }
+}
+
+void day22(Rng &rng, int64_t size, Writer &out) {
+  // 10x10 footprint like the real input, filled to roughly a third
+  const int64_t AREA = 10;
+  int64_t height = size / 10 + 10;
+  std::vector<bool> used((size_t)(AREA * AREA * (height + 5)), false);
+  auto cell = [&](int64_t x, int64_t y, int64_t z) {
+    return used[(size_t)((z * AREA + y) * AREA + x)];
+  };
+  for (int64_t brick = 0; brick < size;) {
+    int64_t axis = rng.range(0, 2);
+    int64_t extent = rng.percent(10) ? 0 : rng.range(1, 4);
+    std::array<int64_t, 3> low = {rng.range(0, AREA - 1), rng.range(0, AREA - 1),
+                                  rng.range(1, height)};
+    std::array<int64_t, 3> high = low;
+    high[(size_t)axis] += extent;
+    if (high[0] >= AREA || high[1] >= AREA) {
+      continue;
+    }
+    bool free = true;
+    for (int64_t x = low[0]; x <= high[0]; ++x) {
+      for (int64_t y = low[1]; y <= high[1]; ++y) {
+        for (int64_t z = low[2]; z <= high[2]; ++z) {
+          free = free && !cell(x, y, z);
+        }
+      }
+    }
+    if (!free) {
+      continue;
+    }
+    for (int64_t x = low[0]; x <= high[0]; ++x) {
+      for (int64_t y = low[1]; y <= high[1]; ++y) {
+        for (int64_t z = low[2]; z <= high[2]; ++z) {
+          used[(size_t)((z * AREA + y) * AREA + x)] = true;
+        }
+      }
+    }
+    out << low[0] << ',' << low[1] << ',' << low[2] << '~' << high[0] << ',' << high[1] << ','
+        << high[2] << '\n';
+    ++brick;
+  }
+}
+
+void day23(Rng &rng, int64_t size, Writer &out) {
+  // A maze carved on the odd cells, with a couple dozen extra walls knocked
+  // out so there are loops and dead ends pruned away, like the real trails.
+  // The slopes next to each junction point from the junction closer to the
+  // start to the one further away, which keeps part 1 a DAG.
+  int64_t side = std::max<int64_t>(5, size - (size + 1) % 2);
+  std::vector<std::string> map((size_t)side, std::string((size_t)side, '#'));
+  auto at = [&map](int64_t r, int64_t c) -> char & { return map[(size_t)r][(size_t)c]; };
+  std::vector<std::pair<int64_t, int64_t>> stack = {{1, 1}};
+  at(1, 1) = '.';
+  const std::array<std::pair<int64_t, int64_t>, 4> steps = {{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
+  while (!stack.empty()) {
+    auto [r, c] = stack.back();
+    std::vector<std::pair<int64_t, int64_t>> next;
+    for (auto [dr, dc] : steps) {
+      if (r + 2 * dr > 0 && r + 2 * dr < side - 1 && c + 2 * dc > 0 && c + 2 * dc < side - 1 &&
+          at(r + 2 * dr, c + 2 * dc) == '#') {
+        next.push_back({dr, dc});
+      }
+    }
+    if (next.empty()) {
+      stack.pop_back();
+      continue;
+    }
+    auto [dr, dc] = next[(size_t)rng.range(0, (int64_t)next.size() - 1)];
+    at(r + dr, c + dc) = '.';
+    at(r + 2 * dr, c + 2 * dc) = '.';
+    stack.push_back({r + 2 * dr, c + 2 * dc});
+  }
+  int64_t rooms = (side - 1) / 2 * ((side - 1) / 2);
+  for (int64_t knocked = 0, tries = 0; knocked < std::min<int64_t>(24, rooms / 10) && tries < 10'000;
+       ++tries) {
+    int64_t r = rng.range(1, side - 2);
+    int64_t c = rng.range(1, side - 2);
+    if ((r + c) % 2 == 1 && at(r, c) == '#') {
+      at(r, c) = '.';
+      ++knocked;
+    }
+  }
+  const std::pair<int64_t, int64_t> start = {0, 1};
+  const std::pair<int64_t, int64_t> end = {side - 1, side - 2};
+  at(start.first, start.second) = '.';
+  at(end.first, end.second) = '.';
+  auto open = [&](int64_t r, int64_t c) {
+    return r >= 0 && r < side && c >= 0 && c < side && at(r, c) != '#';
+  };
+  auto degree = [&](int64_t r, int64_t c) {
+    int64_t d = 0;
+    for (auto [dr, dc] : steps) {
+      d += open(r + dr, c + dc);
+    }
+    return d;
+  };
+  std::vector<std::pair<int64_t, int64_t>> dead_ends;
+  for (int64_t r = 1; r < side - 1; ++r) {
+    for (int64_t c = 1; c < side - 1; ++c) {
+      if (at(r, c) == '.' && degree(r, c) <= 1) {
+        dead_ends.push_back({r, c});
+      }
+    }
+  }
+  while (!dead_ends.empty()) {
+    auto [r, c] = dead_ends.back();
+    dead_ends.pop_back();
+    if (std::pair{r, c} == start || std::pair{r, c} == end || at(r, c) == '#' ||
+        degree(r, c) > 1) {
+      continue;
+    }
+    at(r, c) = '#';
+    for (auto [dr, dc] : steps) {
+      if (open(r + dr, c + dc)) {
+        dead_ends.push_back({r + dr, c + dc});
+      }
+    }
+  }
+
+  std::vector<int64_t> distance((size_t)(side * side), -1);
+  std::vector<std::pair<int64_t, int64_t>> queue = {start};
+  distance[(size_t)start.second] = 0;
+  for (size_t head = 0; head < queue.size(); ++head) {
+    auto [r, c] = queue[head];
+    for (auto [dr, dc] : steps) {
+      if (open(r + dr, c + dc) && distance[(size_t)((r + dr) * side + c + dc)] == -1) {
+        distance[(size_t)((r + dr) * side + c + dc)] = distance[(size_t)(r * side + c)] + 1;
+        queue.push_back({r + dr, c + dc});
+      }
+    }
+  }
+  auto key = [&](int64_t r, int64_t c) { return std::pair{distance[(size_t)(r * side + c)], r * side + c}; };
+  std::vector<std::pair<std::pair<int64_t, int64_t>, char>> slopes;
+  for (int64_t r = 1; r < side - 1; ++r) {
+    for (int64_t c = 1; c < side - 1; ++c) {
+      if (at(r, c) != '.' || degree(r, c) < 3) {
+        continue;
+      }
+      for (size_t dir = 0; dir < steps.size(); ++dir) {
+        auto [dr, dc] = steps[dir];
+        if (!open(r + dr, c + dc)) {
+          continue;
+        }
+        // walk the corridor to the junction (or start / end) at its far side
+        int64_t pr = r;
+        int64_t pc = c;
+        int64_t cr = r + dr;
+        int64_t cc = c + dc;
+        while (degree(cr, cc) == 2) {
+          for (auto [sr, sc] : steps) {
+            if (open(cr + sr, cc + sc) && std::pair{cr + sr, cc + sc} != std::pair{pr, pc}) {
+              pr = cr;
+              pc = cc;
+              cr += sr;
+              cc += sc;
+              break;
+            }
+          }
+        }
+        if (std::pair{r + dr, c + dc} == start || std::pair{r + dr, c + dc} == end) {
+          continue;
+        }
+        bool outgoing = key(r, c) < key(cr, cc);
+        slopes.push_back({{r + dr, c + dc}, ">v<^"[outgoing ? dir : (dir + 2) % 4]});
+      }
+    }
+  }
+  for (auto [where, slope] : slopes) {
+    at(where.first, where.second) = slope;
+  }
+  for (const std::string &row : map) {
+    out << row << '\n';
+  }
+}
+
+struct Generator {
+  const char *size_meaning;
+  void (*generate)(Rng &, int64_t, Writer &);
+};
+const std::array<Generator, 23> GENERATORS = {{
+    {"calibration lines", day1},
+    {"games", day2},
+    {"grid side", day3},
+    {"cards", day4},
+    {"seed ranges and entries per map", day5},
+    {"races", day6},
+    {"hands (capped at 13^5 = 371293 so none repeats)", day7},
+    {"length of the instructions (capped so names fit in 3 letters)", day8},
+    {"histories", day9},
+    {"grid side", day10},
+    {"grid side", day11},
+    {"condition records", day12},
+    {"patterns", day13},
+    {"grid side", day14},
+    {"steps", day15},
+    {"grid side", day16},
+    {"grid side", day17},
+    {"dig instructions", day18},
+    {"workflows and parts", day19},
+    {"counters feeding rx", day20},
+    {"grid side (made odd)", day21},
+    {"bricks", day22},
+    {"grid side (made odd)", day23},
+}};
+
+int32_t main(int32_t argc, char *argv[]) {
+  if (argc < 3 || argc > 4) {
+    std::cerr << "usage: " << argv[0] << " <day> <size> [seed] > input.txt\n";
+    for (size_t day = 0; day < GENERATORS.size(); ++day) {
+      std::cerr << "  day" << day + 1 << ": size = " << GENERATORS[day].size_meaning << "\n";
+    }
+    return 1;
+  }
+  int64_t day = std::atoll(argv[1]);
+  int64_t size = std::atoll(argv[2]);
+  uint64_t seed = argc == 4 ? std::strtoull(argv[3], nullptr, 10) : 2023;
+  if (day < 1 || day > (int64_t)GENERATORS.size() || size < 1) {
+    std::cerr << "day must be 1-" << GENERATORS.size() << " and size positive\n";
+    return 1;
+  }
+  Rng rng(seed);
+  Writer out;
+  GENERATORS[(size_t)day - 1].generate(rng, size, out);
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../common/parse.h"
+// Microbenchmark for common/parse.h against the parse_number that used to be
+// copied into every day. Build once normally and once with -DAOC_PARSE_NO_SWAR
+// to see what the 8 digit chunks buy.
+//   ./parse_bench [numbers per line] [max digits]
+int64_t legacy_parse_number(std::string_view s) {
+  int32_t length = (int32_t)s.length();
+  int64_t value = 0;
+  for (int32_t idx = 0; idx < length; ++idx) {
+    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
+  }
+  return value;
+}
+std::vector<int64_t> legacy_parse_string_to_vec_numbers(std::string_view line) {
+  std::vector<int64_t> numbers;
+  std::vector<std::string_view> num_strings;
+  std::optional<size_t> digit_start;
+  for (size_t idx = 0; idx < line.length(); ++idx) {
+    if (line[idx] >= '0' && line[idx] <= '9' && !digit_start.has_value()) {
+      digit_start = idx;
+    }
+    if ((line[idx] == ' ' || idx == line.length() - 1) && digit_start.has_value()) {
+      size_t end = idx == line.length() - 1 ? line.length() : idx;
+      num_strings.push_back(line.substr(*digit_start, end - *digit_start));
+      digit_start.reset();
+    }
+  }
+  for (std::string_view sv : num_strings) {
+    numbers.push_back(legacy_parse_number(sv));
+  }
+  return numbers;
+}
+template <typename F>
+void time_it(const char *name, size_t bytes, F &&f) {
+  int64_t checksum = 0;
+  double best = 1e30;
+  for (int32_t run = 0; run < 5; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    checksum = f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  std::cout << name << ": " << best * 1e3 << " ms, " << (double)bytes / best / 1e9
+            << " GB/s (checksum " << checksum << ")\n";
+}
+int32_t main(int32_t argc, char *argv[]) {
+  size_t numbers_per_line = argc > 1 ? (size_t)std::stoull(argv[1]) : 20;
+  int32_t max_digits = argc > 2 ? std::stoi(argv[2]) : 18;
+  std::mt19937_64 rng(2023);
+  std::uniform_int_distribution<int32_t> digit_count(1, max_digits);
+  std::vector<std::string> lines(200'000);
+  size_t bytes = 0;
+  for (std::string &line : lines) {
+    for (size_t n = 0; n < numbers_per_line; ++n) {
+      int32_t digits = digit_count(rng);
+      line += (char)('1' + rng() % 9);
+      for (int32_t d = 1; d < digits; ++d) {
+        line += (char)('0' + rng() % 10);
+      }
+      line += n + 1 == numbers_per_line ? "" : " ";
+    }
+    bytes += line.length();
+  }
+  time_it("legacy parse_string_to_vec_numbers", bytes, [&] {
+    int64_t sum = 0;
+    for (const std::string &line : lines) {
+      for (int64_t n : legacy_parse_string_to_vec_numbers(line)) {
+        sum += n;
+      }
+    }
+    return sum;
+  });
+  time_it("parse_string_to_vec_numbers", bytes, [&] {
+    int64_t sum = 0;
+    for (const std::string &line : lines) {
+      for (int64_t n : parse_string_to_vec_numbers(line)) {
+        sum += n;
+      }
+    }
+    return sum;
+  });
+  time_it("for_each_number", bytes, [&] {
+    int64_t sum = 0;
+    for (const std::string &line : lines) {
+      for_each_number(line, [&sum](int64_t n) { sum += n; });
+    }
+    return sum;
+  });
+  std::vector<int64_t> out(numbers_per_line);
+  time_it("parse_numbers into a span", bytes, [&] {
+    int64_t sum = 0;
+    for (const std::string &line : lines) {
+      size_t amt = parse_numbers(line, out);
+      for (size_t idx = 0; idx < amt; ++idx) {
+        sum += out[idx];
+      }
+    }
+    return sum;
+  });
+  return 0;
+}
@@ -0,0 +1,266 @@
+#include "harness.h"
+#include "input.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+// process-wide, so work a phase hands to the thread pool is counted too
+std::atomic<int64_t> allocation_count = 0;
+std::atomic<int64_t> allocated_bytes = 0;
+void *counted_alloc(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add((int64_t)size, std::memory_order_relaxed);
+  void *p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void *counted_aligned_alloc(size_t size, std::align_val_t alignment) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add((int64_t)size, std::memory_order_relaxed);
+  size_t align = (size_t)alignment;
+  // aligned_alloc wants the size to be a multiple of the alignment
+  void *p = std::aligned_alloc(align, (size + align - 1) / align * align);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+} // namespace
+
+void *operator new(size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return counted_alloc(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return counted_alloc(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void *operator new(size_t size, std::align_val_t alignment) {
+  return counted_aligned_alloc(size, alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment) {
+  return counted_aligned_alloc(size, alignment);
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+AllocationCount process_allocations() {
+  return AllocationCount{.allocations = allocation_count.load(std::memory_order_relaxed),
+                         .bytes = allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+std::string answer_text(const std::function<int64_t(const void *)> &part, const void *input) {
+  try {
+    return std::to_string(part(input));
+  } catch (const WideAnswer &wide) {
+    return wide.digits;
+  }
+}
+
+namespace {
+struct PhaseStats {
+  const char *name = "";
+  std::vector<int64_t> nanoseconds = {};
+  int64_t allocations = 0;
+  int64_t bytes = 0;
+  int64_t min() const { return nanoseconds.front(); }
+  int64_t median() const { return nanoseconds[nanoseconds.size() / 2]; }
+  int64_t p99() const {
+    size_t idx = (nanoseconds.size() * 99 + 99) / 100;
+    return nanoseconds[std::min(idx, nanoseconds.size()) - 1];
+  }
+};
+
+template <typename F>
+auto timed(PhaseStats *stats, F &&f) {
+  AllocationCount before = process_allocations();
+  auto start = std::chrono::steady_clock::now();
+  auto result = f();
+  auto end = std::chrono::steady_clock::now();
+  AllocationCount after = process_allocations();
+  if (stats != nullptr) {
+    stats->nanoseconds.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    stats->allocations += after.allocations - before.allocations;
+    stats->bytes += after.bytes - before.bytes;
+  }
+  return result;
+}
+
+std::string json_escape(std::string_view s) {
+  std::string escaped;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void print_us(int64_t ns) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%12.1f", (double)ns / 1e3);
+  std::cout << buffer;
+}
+
+int32_t usage(const char *program) {
+  std::cerr << "usage: " << program
+            << " input.txt [--bench [N]] [--warmup W] [--json] [day options]\n";
+  return 1;
+}
+} // namespace
+
+namespace {
+std::vector<Day> &days() {
+  static std::vector<Day> registered;
+  return registered;
+}
+} // namespace
+
+bool register_day(Day day) {
+  days().push_back(std::move(day));
+  return true;
+}
+
+const std::vector<Day> &registered_days() { return days(); }
+
+namespace {
+int32_t solve_day(const Day &day, const InputFile &input) {
+  std::shared_ptr<const void> parsed = day.parse(input.contents());
+  // each answer is worked out before its line starts, so a part that throws
+  // leaves no half-printed line behind
+  std::string part1 = answer_text(day.part1, parsed.get());
+  std::cout << "PART1: " << part1 << std::endl;
+  std::string part2 = answer_text(day.part2, parsed.get());
+  std::cout << "PART2: " << part2 << std::endl;
+  return 0;
+}
+
+int32_t bench_day(const Day &day, const char *path, const InputFile &input, int64_t runs,
+                  int64_t warmup, bool json) {
+  std::array<PhaseStats, 3> phases = {PhaseStats{.name = "parse"}, PhaseStats{.name = "part1"},
+                                      PhaseStats{.name = "part2"}};
+  std::string part1;
+  std::string part2;
+  for (int64_t run = 0; run < warmup + runs; ++run) {
+    bool measured = run >= warmup;
+    std::shared_ptr<const void> parsed = timed(measured ? &phases[0] : nullptr,
+                                               [&] { return day.parse(input.contents()); });
+    part1 = timed(measured ? &phases[1] : nullptr, [&] { return answer_text(day.part1, parsed.get()); });
+    part2 = timed(measured ? &phases[2] : nullptr, [&] { return answer_text(day.part2, parsed.get()); });
+  }
+  for (PhaseStats &p : phases) {
+    std::sort(p.nanoseconds.begin(), p.nanoseconds.end());
+  }
+
+  if (json) {
+    std::cout << "{\"day\": " << day.number << ", \"input\": \"" << json_escape(path)
+              << "\", \"runs\": " << runs << ", \"warmup\": " << warmup
+              << ", \"part1\": " << part1 << ", \"part2\": " << part2 << ", \"phases\": {";
+    for (size_t idx = 0; idx < phases.size(); ++idx) {
+      const PhaseStats &p = phases[idx];
+      std::cout << (idx == 0 ? "" : ", ") << "\"" << p.name << "\": {\"min_ns\": " << p.min()
+                << ", \"median_ns\": " << p.median() << ", \"p99_ns\": " << p.p99()
+                << ", \"allocations\": " << p.allocations / runs
+                << ", \"bytes_allocated\": " << p.bytes / runs << "}";
+    }
+    std::cout << "}}" << std::endl;
+    return 0;
+  }
+  std::cout << "day" << day.number << " " << path << " (" << runs << " runs after " << warmup
+            << " warm-up)\n";
+  std::cout << "phase      min us   median us      p99 us   allocations   bytes allocated\n";
+  for (const PhaseStats &p : phases) {
+    char name[8];
+    std::snprintf(name, sizeof(name), "%-5s", p.name);
+    std::cout << name;
+    print_us(p.min());
+    print_us(p.median());
+    print_us(p.p99());
+    char allocs[48];
+    std::snprintf(allocs, sizeof(allocs), "%14lld%18lld", (long long)(p.allocations / runs),
+                  (long long)(p.bytes / runs));
+    std::cout << allocs << "\n";
+  }
+  std::cout << "PART1: " << part1 << std::endl;
+  std::cout << "PART2: " << part2 << std::endl;
+  return 0;
+}
+} // namespace
+
+int32_t run_day(const Day &day, int32_t argc, char *argv[]) {
+  if (argc < 2) {
+    return usage(argv[0]);
+  }
+  const char *path = argv[1];
+  bool bench = false;
+  bool json = false;
+  int64_t runs = 20;
+  int64_t warmup = 3;
+  std::vector<std::string_view> day_args;
+  for (int32_t idx = 2; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    if (arg == "--bench") {
+      bench = true;
+      if (idx + 1 < argc && argv[idx + 1][0] != '-') {
+        runs = std::atoll(argv[++idx]);
+      }
+    } else if (arg == "--warmup" && idx + 1 < argc) {
+      warmup = std::atoll(argv[++idx]);
+    } else if (arg == "--json") {
+      bench = true;
+      json = true;
+    } else if (day.command) {
+      day_args.push_back(arg);
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (runs < 1 || warmup < 0) {
+    return usage(argv[0]);
+  }
+  // a day that cannot solve its input throws; report it like aoc_runner does
+  // instead of letting it abort the process
+  try {
+    if (!day_args.empty()) {
+      return day.command(path, day_args);
+    }
+    InputFile input(path);
+    if (!input.is_open()) {
+      std::cerr << path << " file cannot be opened\n";
+      return 1;
+    }
+    return bench ? bench_day(day, path, input, runs, warmup, json) : solve_day(day, input);
+  } catch (const std::exception &e) {
+    std::cerr << "day" << day.number << " " << path << ": " << e.what() << "\n";
+    return 1;
+  }
+}
+
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+// Every day is split into three phases so they can be timed on their own:
+//   parse: input file contents -> the day's own Input type
+//   part1 / part2: const Input & -> answer
+// Each dayN.cpp keeps its code in namespace dayN and registers with AOC_DAY
+// at the bottom, which supplies main. Run as
+//   ./dayN input.txt                       prints PART1 / PART2
+//   ./dayN input.txt --bench [N] [--warmup W] [--json]
+// --bench runs every phase N times (default 20) after W warm-up runs (default
+// 3) and reports min / median / p99 wall time and heap allocations per phase.
+// --json prints the same report as one JSON object so runs can be diffed
+// between commits. An exception thrown by any phase is printed to stderr and
+// the exit code is 1, except WideAnswer, whose digits are printed as the
+// part's answer.
+// A day can also take options of its own through AOC_DAY_COMMAND: every
+// argument the harness does not know is handed, with the input path, to the
+// day's command, which reads the input however it likes, prints its own
+// output and returns the exit code.
+// Built with AOC_RUNNER defined, AOC_DAY adds the day to registered_days()
+// instead, so aoc_runner can link every day into one binary.
+struct Day {
+  int32_t number;
+  std::function<std::shared_ptr<const void>(std::string_view)> parse;
+  std::function<int64_t(const void *)> part1;
+  std::function<int64_t(const void *)> part2;
+  std::function<int32_t(const char *, const std::vector<std::string_view> &)> command;
+};
+
+template <typename Input>
+Day make_day(int32_t number, Input (*parse)(std::string_view),
+             int64_t (*part1)(const Input &), int64_t (*part2)(const Input &)) {
+  return Day{
+      .number = number,
+      .parse = [parse](std::string_view contents) -> std::shared_ptr<const void> {
+        return std::make_shared<const Input>(parse(contents));
+      },
+      .part1 = [part1](const void *input) { return part1(*(const Input *)input); },
+      .part2 = [part2](const void *input) { return part2(*(const Input *)input); },
+      .command = nullptr,
+  };
+}
+
+template <typename Input>
+Day make_day(int32_t number, Input (*parse)(std::string_view),
+             int64_t (*part1)(const Input &), int64_t (*part2)(const Input &),
+             int32_t (*command)(const char *, const std::vector<std::string_view> &)) {
+  Day day = make_day(number, parse, part1, part2);
+  day.command = command;
+  return day;
+}
+
+// Thrown by a part whose answer does not fit int64_t, with the exact answer
+// as decimal digits.
+struct WideAnswer : std::overflow_error {
+  std::string digits;
+  explicit WideAnswer(std::string answer)
+      : std::overflow_error("answer " + answer + " does not fit int64_t"),
+        digits(std::move(answer)) {}
+};
+
+// part(input) as decimal digits, wide answers included
+std::string answer_text(const std::function<int64_t(const void *)> &part, const void *input);
+
+int32_t run_day(const Day &day, int32_t argc, char *argv[]);
+
+bool register_day(Day day);
+const std::vector<Day> &registered_days();
+
+// Heap allocations made by every thread of the process since it started, so
+// work a phase hands to the thread pool is counted too. The harness replaces
+// the global operator new to count them.
+struct AllocationCount {
+  int64_t allocations;
+  int64_t bytes;
+};
+AllocationCount process_allocations();
+
+#ifdef AOC_RUNNER
+#define AOC_DAY(number, parse, part1, part2)                                   \
+  [[maybe_unused]] static const bool aoc_registered = register_day(make_day(   \
+      number, day##number::parse, day##number::part1, day##number::part2));
+#define AOC_DAY_COMMAND(number, parse, part1, part2, command)                  \
+  [[maybe_unused]] static const bool aoc_registered = register_day(            \
+      make_day(number, day##number::parse, day##number::part1,                 \
+               day##number::part2, day##number::command));
+#else
+#define AOC_DAY(number, parse, part1, part2)                                   \
+  int32_t main(int32_t argc, char *argv[]) {                                   \
+    return run_day(make_day(number, day##number::parse, day##number::part1,    \
+                            day##number::part2),                               \
+                   argc, argv);                                                \
+  }
+#define AOC_DAY_COMMAND(number, parse, part1, part2, command)                  \
+  int32_t main(int32_t argc, char *argv[]) {                                   \
+    return run_day(make_day(number, day##number::parse, day##number::part1,    \
+                            day##number::part2, day##number::command),         \
+                   argc, argv);                                                \
+  }
+#endif
@@ -0,0 +1,44 @@
+#include "input.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+InputFile::InputFile(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    size = (size_t)st.st_size;
+    if (size == 0) {
+      opened = true;
+    } else {
+      void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = (const char *)mapping;
+        mapped = true;
+        opened = true;
+      }
+    }
+  }
+  if (!opened) {
+    char buffer[1 << 16];
+    ssize_t amt_read;
+    while ((amt_read = read(fd, buffer, sizeof(buffer))) > 0) {
+      fallback.append(buffer, (size_t)amt_read);
+    }
+    if (amt_read == 0) {
+      data = fallback.data();
+      size = fallback.size();
+      opened = true;
+    }
+  }
+  close(fd);
+}
+InputFile::~InputFile() {
+  if (mapped) {
+    munmap((void *)data, size);
+  }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+// Iterates over the '\n' separated lines of a buffer as string_views into that
+// buffer. Like getline, a trailing newline does not produce an extra empty line.
+struct Lines {
+  std::string_view buffer;
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+    const char *cursor = nullptr;
+    const char *end = nullptr;
+    size_t line_length = 0;
+    Iterator() = default;
+    Iterator(const char *cursor, const char *end) : cursor{cursor}, end{end} {
+      find_line_length();
+    }
+    void find_line_length() {
+      const void *newline = cursor == end ? nullptr : std::memchr(cursor, '\n', end - cursor);
+      line_length = newline == nullptr ? end - cursor : (const char *)newline - cursor;
+    }
+    std::string_view operator*() const { return std::string_view(cursor, line_length); }
+    Iterator &operator++() {
+      cursor += line_length;
+      if (cursor != end) {
+        // skip the newline
+        ++cursor;
+      }
+      find_line_length();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+    bool operator==(const Iterator &other) const { return cursor == other.cursor; }
+  };
+  Iterator begin() const { return Iterator(buffer.data(), buffer.data() + buffer.size()); }
+  Iterator end() const {
+    return Iterator(buffer.data() + buffer.size(), buffer.data() + buffer.size());
+  }
+};
+// Cuts buffer into pieces of about chunk_size bytes that each end right after
+// a newline (the last one at the end of the buffer), so every piece holds
+// whole lines and can be handed to its own thread.
+inline std::vector<std::string_view> line_chunks(std::string_view buffer, size_t chunk_size) {
+  std::vector<std::string_view> chunks;
+  while (!buffer.empty()) {
+    size_t end = buffer.size() <= chunk_size ? std::string_view::npos
+                                             : buffer.find('\n', chunk_size - 1);
+    end = end == std::string_view::npos ? buffer.size() : end + 1;
+    chunks.push_back(buffer.substr(0, end));
+    buffer.remove_prefix(end);
+  }
+  return chunks;
+}
+// Whole input file, memory-mapped read-only. Everything handed out is a view
+// into the mapping, so there is no per-line copy and no cap on line length.
+// Anything that cannot be mapped (pipes, /dev/stdin) is read into memory instead.
+struct InputFile {
+  const char *data = nullptr;
+  size_t size = 0;
+  bool opened = false;
+  bool mapped = false;
+  std::string fallback;
+  explicit InputFile(const char *path);
+  InputFile(const InputFile &) = delete;
+  InputFile &operator=(const InputFile &) = delete;
+  ~InputFile();
+  bool is_open() const { return opened; }
+  std::string_view contents() const { return std::string_view(data, size); }
+  Lines lines() const { return Lines{contents()}; }
+};
@@ -0,0 +1,107 @@
+#include "line_stream.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+LineStream::LineStream(const char *path) {
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  for (std::vector<char> &block : blocks) {
+    block.resize(block_size);
+  }
+  reader = std::thread([this] { read_blocks(); });
+}
+
+LineStream::~LineStream() {
+  if (reader.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    reader.join();
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+void LineStream::read_blocks() {
+  for (size_t idx = 0;; idx ^= 1) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&] { return stopping || !ready[idx]; });
+      if (stopping) {
+        return;
+      }
+    }
+    ssize_t amount;
+    do {
+      amount = read(fd, blocks[idx].data(), block_size);
+    } while (amount < 0 && errno == EINTR);
+    // a read error ends the stream like the end of the file does
+    size_t size = amount > 0 ? (size_t)amount : 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      filled[idx] = size;
+      ready[idx] = true;
+    }
+    changed.notify_all();
+    if (size == 0) {
+      return;
+    }
+  }
+}
+
+bool LineStream::next(std::string_view &line) {
+  if (carry_returned) {
+    carry.clear();
+    carry_returned = false;
+  }
+  while (!finished) {
+    if (!have_block) {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&] { return ready[current]; });
+      have_block = true;
+      position = 0;
+      if (filled[current] == 0) {
+        finished = true;
+        break;
+      }
+    }
+    const char *data = blocks[current].data();
+    size_t size = filled[current];
+    const void *newline = std::memchr(data + position, '\n', size - position);
+    if (newline != nullptr) {
+      size_t end = (size_t)((const char *)newline - data);
+      std::string_view piece(data + position, end - position);
+      position = end + 1;
+      if (carry.empty()) {
+        line = piece;
+      } else {
+        carry.append(piece);
+        line = carry;
+        carry_returned = true;
+      }
+      return true;
+    }
+    // the rest of the block starts a line that ends in a later block
+    carry.append(data + position, size - position);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ready[current] = false;
+    }
+    changed.notify_all();
+    current ^= 1;
+    have_block = false;
+  }
+  if (!carry.empty()) {
+    line = carry;
+    carry_returned = true;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+// Reads a file (or pipe) front to back in blocks on a background thread and
+// hands out its '\n' separated lines, for days that work on a few rows at a
+// time. The next block is read while the current one is worked on, and memory
+// stays at two blocks plus the longest line no matter how big the input is.
+// Like Lines, a trailing newline does not produce an extra empty line.
+struct LineStream {
+  static constexpr size_t block_size = 1 << 20;
+  int fd = -1;
+  std::array<std::vector<char>, 2> blocks;
+  // bytes the reader put in each block, 0 once the file has ended
+  std::array<size_t, 2> filled{};
+  // filled by the reader and not given back by the consumer yet
+  std::array<bool, 2> ready{};
+  bool stopping = false;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread reader;
+
+  // consumer side
+  size_t current = 0;
+  size_t position = 0;
+  bool have_block = false;
+  bool finished = false;
+  // a line that crossed a block boundary
+  std::string carry;
+  bool carry_returned = false;
+
+  explicit LineStream(const char *path);
+  LineStream(const LineStream &) = delete;
+  LineStream &operator=(const LineStream &) = delete;
+  ~LineStream();
+  bool is_open() const { return fd >= 0; }
+  // the next line, valid until the following call; false at the end
+  bool next(std::string_view &line);
+
+  void read_blocks();
+};
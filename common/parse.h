@@ -0,0 +1,121 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+// Integer parsing shared by every day. Everything here is a single forward pass
+// over the input with integer math only.
+//
+// The 8 digits at a time SWAR path is on by default; build with
+// -DAOC_PARSE_NO_SWAR to get the plain digit loop instead.
+#if !defined(AOC_PARSE_NO_SWAR) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define AOC_PARSE_SWAR 1
+#endif
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+#ifdef AOC_PARSE_SWAR
+// true when all 8 bytes of chunk are ASCII digits
+inline bool is_eight_digits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+// chunk holds 8 ASCII digits, most significant digit in the lowest byte
+inline uint64_t parse_eight_digits(uint64_t chunk) {
+  const uint64_t mask = 0x000000FF000000FF;
+  const uint64_t mul1 = 100 + (1000000ULL << 32);
+  const uint64_t mul2 = 1 + (10000ULL << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+}
+#endif
+
+// Parses the digits starting at s[idx] and leaves idx on the first character
+// that is not a digit.
+inline uint64_t parse_digits(std::string_view s, size_t &idx) {
+  uint64_t value = 0;
+#ifdef AOC_PARSE_SWAR
+  while (idx + 8 <= s.length()) {
+    uint64_t chunk;
+    std::memcpy(&chunk, s.data() + idx, sizeof(chunk));
+    if (!is_eight_digits(chunk)) {
+      break;
+    }
+    value = value * 100'000'000 + parse_eight_digits(chunk);
+    idx += 8;
+  }
+#endif
+  while (idx < s.length() && is_digit(s[idx])) {
+    value = value * 10 + (uint64_t)(s[idx] - '0');
+    ++idx;
+  }
+  return value;
+}
+
+// Parses an optionally negative number from the start of s, stopping at the
+// first character that is not a digit.
+inline int64_t parse_number(std::string_view s) {
+  size_t idx = 0;
+  bool negative = !s.empty() && s[0] == '-';
+  if (negative) {
+    ++idx;
+  }
+  uint64_t value = parse_digits(s, idx);
+  return negative ? -(int64_t)value : (int64_t)value;
+}
+
+// Finds the next number in s at or after idx and stores it in number. Fields are
+// separated by delimiter; the first number in a field is taken and anything
+// else in the field (labels, padding, a second number) is skipped. Returns
+// false once s has no more numbers.
+inline bool next_number(std::string_view s, size_t &idx, int64_t &number, char delimiter = ' ') {
+  while (idx < s.length()) {
+    char c = s[idx];
+    bool starts_negative = c == '-' && idx + 1 < s.length() && is_digit(s[idx + 1]);
+    if (!is_digit(c) && !starts_negative) {
+      ++idx;
+      continue;
+    }
+    if (starts_negative) {
+      ++idx;
+    }
+    uint64_t value = parse_digits(s, idx);
+    number = starts_negative ? -(int64_t)value : (int64_t)value;
+    while (idx < s.length() && s[idx] != delimiter) {
+      ++idx;
+    }
+    return true;
+  }
+  return false;
+}
+
+// Calls on_number(int64_t) for every number in s.
+template <typename F>
+void for_each_number(std::string_view s, F &&on_number, char delimiter = ' ') {
+  size_t idx = 0;
+  int64_t number;
+  while (next_number(s, idx, number, delimiter)) {
+    on_number(number);
+  }
+}
+
+// Writes the numbers in s into out and returns how many were written. Parsing
+// stops once out is full.
+inline size_t parse_numbers(std::string_view s, std::span<int64_t> out, char delimiter = ' ') {
+  size_t idx = 0;
+  size_t count = 0;
+  while (count < out.size() && next_number(s, idx, out[count], delimiter)) {
+    ++count;
+  }
+  return count;
+}
+
+inline std::vector<int64_t> parse_string_to_vec_numbers(std::string_view s, char delimiter = ' ') {
+  std::vector<int64_t> numbers;
+  for_each_number(s, [&numbers](int64_t n) { numbers.push_back(n); }, delimiter);
+  return numbers;
+}
@@ -0,0 +1,142 @@
+#include "pool.h"
+#include <chrono>
+
+namespace {
+// which pool and queue the current thread works for, if any
+thread_local ThreadPool *current_pool = nullptr;
+thread_local size_t current_worker = 0;
+size_t requested_threads = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+  threads = std::max<size_t>(threads, 1);
+  for (size_t idx = 0; idx <= threads; ++idx) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (size_t idx = 0; idx < threads; ++idx) {
+    workers.emplace_back([this, idx] { work(idx); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread &t : workers) {
+    t.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  Queue &queue = current_pool == this ? *queues[current_worker] : *queues.back();
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  ++queued;
+  // taking the lock orders this push before a worker's check for work, so
+  // the wake up cannot be lost
+  { std::lock_guard<std::mutex> lock(sleep_mutex); }
+  wake.notify_one();
+}
+
+bool ThreadPool::pop(size_t own, std::function<void()> &task) {
+  auto take = [&](size_t idx, bool back) {
+    Queue &queue = *queues[idx];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    if (back) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    --queued;
+    return true;
+  };
+  // newest own task first (it is likely still in cache), then the oldest
+  // outside submission, then steal the oldest task of another worker
+  if (own < workers.size() && take(own, true)) {
+    return true;
+  }
+  if (take(queues.size() - 1, false)) {
+    return true;
+  }
+  for (size_t offset = 1; offset < workers.size(); ++offset) {
+    if (take((own + offset) % workers.size(), false)) {
+      return true;
+    }
+  }
+  return own >= workers.size() && take(0, false);
+}
+
+bool ThreadPool::run_one() {
+  std::function<void()> task;
+  if (!pop(current_pool == this ? current_worker : workers.size(), task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::work(size_t worker) {
+  current_pool = this;
+  current_worker = worker;
+  while (true) {
+    std::function<void()> task;
+    if (pop(worker, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    wake.wait(lock, [this] { return stopping || queued > 0; });
+    if (stopping && queued == 0) {
+      return;
+    }
+  }
+}
+
+ThreadPool &pool() {
+  static ThreadPool instance(requested_threads != 0 ? requested_threads
+                                                    : std::thread::hardware_concurrency());
+  return instance;
+}
+
+void set_pool_threads(size_t threads) { requested_threads = threads; }
+
+void TaskGroup::run(std::function<void()> task) {
+  ++pending;
+  pool().submit([this, task = std::move(task)] {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    --pending;
+  });
+}
+
+void TaskGroup::wait() {
+  int64_t idle = 0;
+  while (pending > 0) {
+    if (pool().run_one()) {
+      idle = 0;
+    } else if (++idle < 64) {
+      std::this_thread::yield();
+    } else {
+      // the rest of the group is running on other threads
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
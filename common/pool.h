@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+// Work-stealing thread pool shared by aoc_runner and by days that split their
+// own work. Every worker pushes and pops the back of its own deque and steals
+// from the front of the others; tasks submitted by threads outside the pool
+// go to a shared queue. Waiting on a TaskGroup runs queued tasks instead of
+// blocking, so a task may start and wait for subtasks without tying up a
+// worker.
+struct ThreadPool {
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+  // one per worker, then the shared queue
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<int64_t> queued = 0;
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+
+  explicit ThreadPool(size_t threads);
+  ~ThreadPool();
+  void submit(std::function<void()> task);
+  // runs one queued task on the calling thread, false if there was none
+  bool run_one();
+  size_t size() const { return workers.size(); }
+
+  void work(size_t worker);
+  bool pop(size_t own, std::function<void()> &task);
+};
+
+// The process wide pool, started on first use with hardware_concurrency
+// workers unless set_pool_threads was called before that.
+ThreadPool &pool();
+void set_pool_threads(size_t threads);
+
+struct TaskGroup {
+  std::atomic<int64_t> pending = 0;
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  void run(std::function<void()> task);
+  // helps with queued tasks until every task of the group finished, then
+  // rethrows the first exception one of them threw
+  void wait();
+};
+
+// f(idx) for every idx in [0, count), in chunks spread over the pool
+template <typename F>
+void parallel_for(size_t count, F &&f) {
+  size_t chunks = std::min(count, pool().size() * 4);
+  if (chunks <= 1) {
+    for (size_t idx = 0; idx < count; ++idx) {
+      f(idx);
+    }
+    return;
+  }
+  TaskGroup group;
+  for (size_t chunk = 0; chunk < chunks; ++chunk) {
+    group.run([&f, chunk, chunks, count] {
+      for (size_t idx = count * chunk / chunks; idx < count * (chunk + 1) / chunks; ++idx) {
+        f(idx);
+      }
+    });
+  }
+  group.wait();
+}
+
+// sum of f(idx) for every idx in [0, count), each index summed on its own
+template <typename F>
+int64_t parallel_sum(size_t count, F &&f) {
+  std::vector<int64_t> sums(count, 0);
+  parallel_for(count, [&](size_t idx) { sums[idx] = f(idx); });
+  return std::accumulate(sums.begin(), sums.end(), (int64_t)0);
+}
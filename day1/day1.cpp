@@ -1,106 +1,216 @@
+#include <array>
+#include <bit>
+#include <cstring>
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <cstdint>
-int32_t main() {
-  std::ifstream input("day1_input.txt");
-  if (!input.is_open()) {
-    std::cerr << "Could not open input\n";
-    return 1;
+#include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/pool.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+namespace day1 {
+// Every line is independent, so the input is cut into newline aligned chunks
+// that are summed on the pool and added up at the end.
+struct Calibration {
+  std::vector<std::string_view> chunks;
+};
+Calibration parse(std::string_view input) {
+  return Calibration{line_chunks(input, 1 << 20)};
+}
+template <typename F>
+int64_t sum_chunks(const Calibration &calibration, F &&sum_chunk) {
+  return parallel_sum(calibration.chunks.size(),
+                      [&](size_t idx) { return sum_chunk(calibration.chunks[idx]); });
+}
+// Part 1 sweeps the whole buffer 32 bytes at a time. Each block is turned
+// into a bitmask of its digits and one of its newlines, and every line only
+// needs the lowest and highest digit bit between two newlines, so the work is
+// per block and per line rather than per byte.
+struct BlockMasks {
+  uint32_t digits;
+  uint32_t newlines;
+};
+BlockMasks block_masks_scalar(const char *block) {
+  BlockMasks masks{0, 0};
+  for (int32_t idx = 0; idx < 32; ++idx) {
+    masks.digits |= (uint32_t)((uint8_t)(block[idx] - '0') < 10) << idx;
+    masks.newlines |= (uint32_t)(block[idx] == '\n') << idx;
   }
-  std::string line(1000, '\0');
-  int32_t sum1 = 0;
-  int32_t sum2 = 0;
-  std::string number_names[9] = {
-    "one",
-    "two",
-    "three",
-    "four",
-    "five",
-    "six",
-    "seven",
-    "eight",
-    "nine"
-  };
-  while (input.getline(&line[0], line.length())) {
-    int32_t idx_of_first;
-    int32_t idx_of_second;
-    for (int32_t idx = 0; idx < input.gcount(); ++idx) {
-      if (line[idx] >= '0' && line[idx] <= '9') {
-        sum1 += ((line[idx] - '0') * 10);
-        idx_of_first = idx;
-        break;
+  return masks;
+}
+#if defined(__x86_64__)
+BlockMasks block_masks_sse2(const char *block) {
+  BlockMasks masks{0, 0};
+  for (int32_t half = 0; half < 2; ++half) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)(block + half * 16));
+    // signed compares: bytes from 0x80 up are negative, so below '0'
+    __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                   _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+    __m128i newlines = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'));
+    masks.digits |= (uint32_t)_mm_movemask_epi8(digits) << (half * 16);
+    masks.newlines |= (uint32_t)_mm_movemask_epi8(newlines) << (half * 16);
+  }
+  return masks;
+}
+__attribute__((target("avx2"))) BlockMasks block_masks_avx2(const char *block) {
+  __m256i bytes = _mm256_loadu_si256((const __m256i *)block);
+  __m256i digits = _mm256_andnot_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('9')),
+                                       _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('0' - 1)));
+  __m256i newlines = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+  return BlockMasks{(uint32_t)_mm256_movemask_epi8(digits),
+                    (uint32_t)_mm256_movemask_epi8(newlines)};
+}
+#endif
+
+template <BlockMasks (*block_masks)(const char *)>
+[[gnu::always_inline]] inline int64_t sum_first_last_digits(std::string_view input) {
+  int64_t sum = 0;
+  int32_t first = -1;
+  int32_t last = 0;
+  auto take_digits = [&](const char *block, uint32_t digits) {
+    if (digits != 0) {
+      if (first < 0) {
+        first = block[std::countr_zero(digits)] - '0';
       }
+      last = block[31 - std::countl_zero(digits)] - '0';
     }
-    for (int32_t idx = input.gcount() - 1; idx >= 0; --idx) {
-      if (line[idx] >= '0' && line[idx] <= '9') {
-        sum1 += (line[idx] - '0');
-        idx_of_second = idx;
-        break;
+  };
+  auto sweep = [&](const char *block) {
+    BlockMasks masks = block_masks(block);
+    while (masks.newlines != 0) {
+      int32_t newline = std::countr_zero(masks.newlines);
+      uint32_t before = (1u << newline) - 1;
+      take_digits(block, masks.digits & before);
+      if (first >= 0) {
+        sum += first * 10 + last;
       }
+      first = -1;
+      masks.digits &= ~(before | (1u << newline));
+      masks.newlines &= masks.newlines - 1;
     }
-    int32_t part2_first_digit = -1;
-    for (int32_t idx = 0; idx < idx_of_first; ++idx) {
-      bool break_out = false;
-        for (int32_t names_index = 0; names_index < 9; ++names_index) {
-          std::string name = number_names[names_index];
-          if (name.length() - 1 + idx < (uint32_t)idx_of_first) {
-            bool equal = true;
-            int32_t idx_temp = idx;
-            for (int32_t name_idx = 0; name_idx < (int32_t)name.length(); ++name_idx) {
-              if (name[name_idx] != line[idx_temp]) {
-                equal = false;
-                break;
-              }
-              ++idx_temp;
-            }
-            if (equal) {
-              part2_first_digit = (names_index + 1) * 10;
-              break_out = true;
-              break;
-            }
-          }
-        }
-        if (break_out)
-          break;
+    take_digits(block, masks.digits);
+  };
+  size_t idx = 0;
+  for (; idx + 32 <= input.size(); idx += 32) {
+    sweep(input.data() + idx);
+  }
+  if (idx < input.size()) {
+    // the mapped file may end right after the input, so the tail is copied
+    // into a block that ends in a newline
+    char tail[32] = {};
+    std::memcpy(tail, input.data() + idx, input.size() - idx);
+    tail[input.size() - idx] = '\n';
+    sweep(tail);
+  } else if (first >= 0) {
+    sum += first * 10 + last;
+  }
+  return sum;
+}
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) int64_t sum_first_last_digits_avx2(std::string_view input) {
+  return sum_first_last_digits<block_masks_avx2>(input);
+}
+#endif
+
+int64_t part1(const Calibration &calibration) {
+#if defined(__x86_64__)
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  if (avx2) {
+    return sum_chunks(calibration, sum_first_last_digits_avx2);
+  }
+  return sum_chunks(calibration, sum_first_last_digits<block_masks_sse2>);
+#else
+  return sum_chunks(calibration, sum_first_last_digits<block_masks_scalar>);
+#endif
+}
+// Aho-Corasick automaton over the digits and the spelled out digits, built at
+// compile time and flattened into a full transition table, so scanning a line
+// is one table lookup per byte. No name is a substring of another, so the
+// first match to end is also the first to start. The reversed automaton is
+// run from the back of the line to find the last match.
+struct Automaton {
+  static constexpr int32_t max_states = 64;
+  std::array<std::array<uint8_t, 256>, max_states> next{};
+  // value of the digit that ends in this state, -1 if none
+  std::array<int8_t, max_states> digit{};
+};
+constexpr Automaton build_automaton(bool reversed) {
+  constexpr std::string_view number_names[9] = {
+    "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+  Automaton automaton;
+  automaton.digit.fill(-1);
+  int32_t states = 1;
+  auto insert = [&](std::string_view name, int8_t value) {
+    uint8_t state = 0;
+    for (size_t idx = 0; idx < name.length(); ++idx) {
+      uint8_t c = (uint8_t)name[reversed ? name.length() - 1 - idx : idx];
+      if (automaton.next[state][c] == 0) {
+        automaton.next[state][c] = (uint8_t)states++;
+      }
+      state = automaton.next[state][c];
     }
-    if (part2_first_digit == -1) {
-      sum2 += (line[idx_of_first] - '0') * 10;
-    } else {
-      sum2 += part2_first_digit;
+    automaton.digit[state] = value;
+  };
+  const char digits[] = "0123456789";
+  for (int8_t value = 0; value < 10; ++value) {
+    insert(std::string_view(digits + value, 1), value);
+  }
+  for (int8_t value = 1; value <= 9; ++value) {
+    insert(number_names[value - 1], value);
+  }
+  // breadth first, so the failure state of every trie node is finished
+  // before its children need it
+  std::array<uint8_t, Automaton::max_states> fail{};
+  std::array<uint8_t, Automaton::max_states> queue{};
+  int32_t head = 0;
+  int32_t tail = 0;
+  queue[tail++] = 0;
+  while (head < tail) {
+    uint8_t state = queue[head++];
+    for (int32_t c = 0; c < 256; ++c) {
+      uint8_t child = automaton.next[state][c];
+      if (child == 0) {
+        automaton.next[state][c] = state == 0 ? 0 : automaton.next[fail[state]][c];
+        continue;
+      }
+      fail[child] = state == 0 ? 0 : automaton.next[fail[state]][c];
+      if (automaton.digit[child] < 0) {
+        automaton.digit[child] = automaton.digit[fail[child]];
+      }
+      queue[tail++] = child;
     }
+  }
+  return automaton;
+}
+constexpr Automaton forward = build_automaton(false);
+constexpr Automaton backward = build_automaton(true);
 
-    int32_t part2_second_digit = -1;
-    for (int32_t idx = input.gcount() - 1; idx >= idx_of_second + 1; --idx) {
-      bool break_out = false;
-      for (int32_t names_index = 0; names_index < 9; ++names_index) {
-        std::string name = number_names[names_index];
-        if (name.length() - 1 + idx < (uint32_t)input.gcount()) { 
-          bool equal = true;
-          int32_t idx_temp = idx;
-          for (int32_t name_idx = 0; name_idx < (int32_t)name.length(); ++name_idx) {
-            if (name[name_idx] != line[idx_temp]) {
-              equal = false;
-              break;
-            }
-            ++idx_temp;
-          }
-          if (equal) {
-            part2_second_digit = (names_index + 1);
-            break_out = true;
-            break;
-          }
+int64_t part2(const Calibration &calibration) {
+  return sum_chunks(calibration, [](std::string_view chunk) {
+    int64_t sum2 = 0;
+    for (std::string_view line : Lines{chunk}) {
+      uint8_t state = 0;
+      for (char c : line) {
+        state = forward.next[state][(uint8_t)c];
+        if (forward.digit[state] >= 0) {
+          sum2 += forward.digit[state] * 10;
+          break;
+        }
+      }
+      state = 0;
+      for (auto it = line.rbegin(); it != line.rend(); ++it) {
+        state = backward.next[state][(uint8_t)*it];
+        if (backward.digit[state] >= 0) {
+          sum2 += backward.digit[state];
+          break;
         }
       }
-      if (break_out)
-        break;
-    }
-    if (part2_second_digit == -1) {
-      sum2 += (line[idx_of_second] - '0');
-    } else {
-      sum2 += part2_second_digit;
     }
-  }
-  std::cout << "sum: " << sum1 << "\n";
-  std::cout << "sum2: " << sum2 << "\n";
+    return sum2;
+  });
 }
+} // namespace day1
+AOC_DAY(1, parse, part1, part2)
@@ -2,7 +2,6 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
 #include <tuple>
 #include <optional>
 #include <cmath>
@@ -14,49 +13,11 @@
 #include <numeric>
 #include <cassert>
 #include <ranges>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day10 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int32_t length) {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int32_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (
-      ((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') || line[num_parser_idx] == '-') &&
-      !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == ' ' || num_parser_idx == length - 1) && digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-      {has_neg ? Sign::Neg : Sign::Pos,
-      std::string_view(line + actual_digit_start, num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-      case Sign::Pos: numbers.push_back(num); break;
-      case Sign::Neg: numbers.push_back(-num); break;
-    }
-  }
-  return numbers;
-}
 std::ostream& operator<<(std::ostream &os, const std::vector<int64_t> &v) {
   for (const int64_t &n : v) {
     os << n << " ";
@@ -299,33 +260,25 @@ Turns get_looking_turn(const InsideSide& inside_side, const Turns& t) {
   }
   return ret;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int32_t LINE_CAPACITY = 1024 * 2;
-  char line[LINE_CAPACITY];
+std::vector<std::string> parse(std::string_view input) {
   std::vector<std::string> pipes;
   std::optional<int32_t> single_size_of_width;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int32_t line_length = input.gcount() - 1;
+  for (std::string_view line : Lines{input}) {
+    int32_t line_length = (int32_t)line.length();
     if (single_size_of_width.has_value() && *single_size_of_width != line_length) {
       throw "WIDTHS ARE NOT EQUAL";
     } else {
       single_size_of_width = line_length;
     }
-    pipes.push_back(std::string(line, line_length));
+    pipes.push_back(std::string(line));
   }
+  return pipes;
+}
+// the loop through S, without the step back onto S
+std::vector<Step> find_loop(const std::vector<std::string> &pipes) {
   auto [s_row, s_col] = find_S(pipes);
   std::vector<char> S_options = find_S_options(pipes, {s_row, s_col});
   std::vector<Step> first_way;
-  int32_t part1 = 0;
   for (const char &s_pipe : S_options) {
     char curr_pipe = s_pipe;
     {
@@ -345,12 +298,22 @@ int32_t main(int32_t argc, char *argv[]) {
     // removing the S location step after
     if (first_way.size() > 0) {
       first_way.pop_back();
-      part1 = std::max(part1, first_way[(first_way.size() - 1)/2].step_number);
       break;
     }
   }
-  std::cout << "PART1: " << part1 << std::endl;
-
+  return first_way;
+}
+int64_t part1(const std::vector<std::string> &pipes) {
+  std::vector<Step> first_way = find_loop(pipes);
+  int32_t part1 = 0;
+  if (first_way.size() > 0) {
+    part1 = first_way[(first_way.size() - 1)/2].step_number;
+  }
+  return part1;
+}
+int64_t part2(const std::vector<std::string> &pipes) {
+  auto [s_row, s_col] = find_S(pipes);
+  std::vector<Step> first_way = find_loop(pipes);
   InsideSide inside_side = get_inside_side(first_way, s_row, s_col);
   //switch (inside_side) {
   //  case InsideSide::Left: std::cerr << "LEFT\n"; break;
@@ -426,6 +389,7 @@ int32_t main(int32_t argc, char *argv[]) {
       }
     }
   }
-  std::cout << "PART2: " << part2 << std::endl;
-  return 0;
+  return part2;
 }
+} // namespace day10
+AOC_DAY(10, parse, part1, part2)
@@ -2,7 +2,6 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
 #include <tuple>
 #include <optional>
 #include <cmath>
@@ -14,49 +13,11 @@
 #include <numeric>
 #include <cassert>
 #include <ranges>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day11 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int32_t length) {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int32_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (
-      ((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') || line[num_parser_idx] == '-') &&
-      !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == ' ' || num_parser_idx == length - 1) && digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-      {has_neg ? Sign::Neg : Sign::Pos,
-      std::string_view(line + actual_digit_start, num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-      case Sign::Pos: numbers.push_back(num); break;
-      case Sign::Neg: numbers.push_back(-num); break;
-    }
-  }
-  return numbers;
-}
 template<typename T> requires std::is_integral_v<T>
 std::ostream& operator<<(std::ostream &os, const std::vector<T> &v) {
   for (const T &n : v) {
@@ -100,23 +61,14 @@ const std::vector<int32_t>& cols
   });
   return sum;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int32_t LINE_CAPACITY = 1024 * 2;
-  char line[LINE_CAPACITY];
+std::vector<std::string> parse(std::string_view input) {
   std::vector<std::string> image;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int32_t line_length = (int32_t)input.gcount() - 1;
-    image.push_back(std::string(line, line_length));
+  for (std::string_view line : Lines{input}) {
+    image.push_back(std::string(line));
   }
+  return image;
+}
+int64_t sum_of_distances(int32_t expansion, const std::vector<std::string> &image) {
   std::vector<int32_t> rows;
   for (int32_t idx = 0; idx < (int32_t)image.size(); ++idx) {
     auto find_res = std::find_if(image[idx].begin(), image[idx].end(), [](char c){return c == '#';});
@@ -152,9 +104,13 @@ int32_t main(int32_t argc, char *argv[]) {
     }
   }
   assert(pairs.size() == galaxies.size() * (galaxies.size() - 1) / 2);
-  int64_t part1 = get_ans(2, pairs, image, rows, cols);
-  std::cout << "PART1: " << part1 << std::endl;
-  int64_t part2 = get_ans(1'000'000, pairs, image, rows, cols);
-  std::cout << "PART2: " << part2 << std::endl;
-  return 0;
+  return get_ans(expansion, pairs, image, rows, cols);
+}
+int64_t part1(const std::vector<std::string> &image) {
+  return sum_of_distances(2, image);
+}
+int64_t part2(const std::vector<std::string> &image) {
+  return sum_of_distances(1'000'000, image);
 }
+} // namespace day11
+AOC_DAY(11, parse, part1, part2)
@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -15,56 +14,11 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day12 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, size_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (size_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -227,31 +181,30 @@ size_t dfs_with_group_size(const std::string &record, size_t idx_record,
   memo[idx_record][idx_group_size] = return_val;
   return return_val;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int32_t LINE_CAPACITY = 1024 * 2;
-  char line[LINE_CAPACITY];
+struct Records {
   std::vector<std::string> condition_records;
   std::vector<std::vector<int64_t>> group_sizes;
-  while (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
+};
+Records parse(std::string_view input) {
+  Records records;
+  std::vector<std::string> &condition_records = records.condition_records;
+  std::vector<std::vector<int64_t>> &group_sizes = records.group_sizes;
+  for (std::string_view line : Lines{input}) {
+    size_t line_length = line.length();
     for (size_t idx_space = 0; idx_space < line_length; ++idx_space) {
       if (line[idx_space] == ' ') {
-        condition_records.push_back(std::string(line, idx_space));
+        condition_records.push_back(std::string(line.substr(0, idx_space)));
         group_sizes.push_back(parse_string_to_vec_numbers(
-            line + idx_space, line_length - idx_space, ','));
+            line.substr(idx_space), ','));
         break;
       }
     }
   }
+  return records;
+}
+int64_t part1(const Records &records) {
+  const std::vector<std::string> &condition_records = records.condition_records;
+  const std::vector<std::vector<int64_t>> &group_sizes = records.group_sizes;
   int64_t part1 = 0;
   std::vector<size_t> right_ans(condition_records.size(), 0);
   for (size_t idx_condition_record = 0;
@@ -277,8 +230,11 @@ int32_t main(int32_t argc, char *argv[]) {
     right_ans[idx_condition_record] = filtered.size();
     part1 += filtered.size();
   }
-  std::cout << "PART1: " << part1 << std::endl;
-
+  return part1;
+}
+int64_t part2(const Records &records) {
+  std::vector<std::string> condition_records = records.condition_records;
+  std::vector<std::vector<int64_t>> group_sizes = records.group_sizes;
   std::transform(condition_records.begin(), condition_records.end(),
                  condition_records.begin(), [](const std::string &cr) {
                    return cr + "?" + cr + "?" + cr + "?" + cr + "?" + cr;
@@ -301,7 +257,7 @@ int32_t main(int32_t argc, char *argv[]) {
         record.length(), std::vector<int64_t>(group_sizes[idx].size(), -1));
     part2 += dfs_with_group_size(record, 0, group_sizes[idx], 0, memo);
   }
-  std::cout << "PART2: " << part2 << std::endl;
-
-  return 0;
+  return part2;
 }
+} // namespace day12
+AOC_DAY(12, parse, part1, part2)
@@ -2,7 +2,6 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
 #include <tuple>
 #include <optional>
 #include <cmath>
@@ -14,49 +13,12 @@
 #include <numeric>
 #include <cassert>
 #include <ranges>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+#include "../common/pool.h"
+namespace day13 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, size_t length, char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (size_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (
-      ((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') || line[num_parser_idx] == '-') &&
-      !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) && digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-      {has_neg ? Sign::Neg : Sign::Pos,
-      std::string_view(line + actual_digit_start, num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-      case Sign::Pos: numbers.push_back(num); break;
-      case Sign::Neg: numbers.push_back(-num); break;
-    }
-  }
-  return numbers;
-}
 template<typename T> requires std::is_integral_v<T>
 std::ostream& operator<<(std::ostream &os, const std::vector<T> &v) {
   for (const T &n : v) {
@@ -157,45 +119,35 @@ int64_t check_reflections(const std::vector<std::string>& pattern) {
   }
   return sum;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int32_t LINE_CAPACITY = 1024 * 2;
-  char line[LINE_CAPACITY];
+std::vector<std::vector<std::string>> parse(std::string_view input) {
   std::vector<std::vector<std::string>> patterns;
   std::vector<std::string> pattern;
-  while (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
+  for (std::string_view line : Lines{input}) {
+    size_t line_length = line.length();
     if (line_length != 0) {
-      pattern.push_back(std::string(line, line_length));
+      pattern.push_back(std::string(line));
     } else {
       patterns.push_back(pattern);
       pattern.clear();
     }
   }
   patterns.push_back(pattern);
-  int64_t part1 = 0;
-  for (const std::vector<std::string>& pattern : patterns) {
-    int64_t sum = check_reflections<true>(pattern);
-    if (sum > int64_t{0}) {
-      part1 += sum;
-    }
-  }
-  std::cout << "PART1: " << part1 << std::endl;
-  int64_t part2 = 0;
-  for (const std::vector<std::string>& pattern : patterns) {
-    int64_t sum = check_reflections<false>(pattern);
-    if (sum > int64_t{0}) {
-      part2 += sum;
-    }
-  }
-  std::cout << "PART2: " << part2 << std::endl;
-  return 0;
+  return patterns;
+}
+template <bool part1>
+int64_t sum_reflections(const std::vector<std::vector<std::string>> &patterns) {
+  // patterns are independent, so each one is a task for the pool
+  std::vector<int64_t> sums(patterns.size());
+  parallel_for(patterns.size(), [&](size_t idx) {
+    sums[idx] = std::max(check_reflections<part1>(patterns[idx]), int64_t{0});
+  });
+  return std::accumulate(sums.begin(), sums.end(), int64_t{0});
+}
+int64_t part1(const std::vector<std::vector<std::string>> &patterns) {
+  return sum_reflections<true>(patterns);
+}
+int64_t part2(const std::vector<std::vector<std::string>> &patterns) {
+  return sum_reflections<false>(patterns);
 }
+} // namespace day13
+AOC_DAY(13, parse, part1, part2)
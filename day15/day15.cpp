@@ -2,7 +2,6 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
 #include <tuple>
 #include <optional>
 #include <cmath>
@@ -15,49 +14,11 @@
 #include <cassert>
 #include <ranges>
 #include <format>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day15 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, size_t length, char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (size_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (
-      ((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') || line[num_parser_idx] == '-') &&
-      !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) && digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-      {has_neg ? Sign::Neg : Sign::Pos,
-      std::string_view(line + actual_digit_start, num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-      case Sign::Pos: numbers.push_back(num); break;
-      case Sign::Neg: numbers.push_back(-num); break;
-    }
-  }
-  return numbers;
-}
 template<typename T> requires std::is_integral_v<T>
 std::ostream& operator<<(std::ostream &os, const std::vector<T> &v) {
   for (const T &n : v) {
@@ -75,7 +36,7 @@ struct Range {
   size_t length;
 };
 
-std::vector<std::string_view> get_steps(const std::string& init_seq) {
+std::vector<std::string_view> get_steps(std::string_view init_seq) {
   std::vector<std::string_view> steps;
   size_t start = 0;
   for (size_t idx = 0; idx < init_seq.length(); ++idx) {
@@ -88,25 +49,15 @@ std::vector<std::string_view> get_steps(const std::string& init_seq) {
   return steps;
 }
 
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const size_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
-  std::string initialization_seq;
-  while (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
-    initialization_seq = std::string(line, line_length);
+std::vector<std::string_view> parse(std::string_view input) {
+  std::string_view initialization_seq;
+  for (std::string_view line : Lines{input}) {
+    initialization_seq = line;
   }
+  return get_steps(initialization_seq);
+}
+int64_t part1(const std::vector<std::string_view> &steps) {
   size_t part1 = 0;
-  std::vector<std::string_view> steps = get_steps(initialization_seq);
   for (const std::string_view& sv : steps) {
     size_t result = 0;
     for (const char& c : sv) {
@@ -116,8 +67,9 @@ int32_t main(int32_t argc, char *argv[]) {
     }
     part1 += result;
   }
-  std::cout << std::format("PART1: {}\n", part1);
-
+  return part1;
+}
+int64_t part2(const std::vector<std::string_view> &steps) {
 
   struct Lens {
     std::string_view label;
@@ -168,6 +120,7 @@ int32_t main(int32_t argc, char *argv[]) {
     }
     part2 += focus_power;
   }
-  std::cout << std::format("PART2: {}\n", part2);
-  return 0;
+  return part2;
 }
+} // namespace day15
+AOC_DAY(15, parse, part1, part2)
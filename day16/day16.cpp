@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -16,56 +15,12 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+#include "../common/pool.h"
+namespace day16 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, size_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (size_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -344,45 +299,32 @@ size_t run_beam(const std::vector<std::string> &contraption, Coord initial_tile,
   return traveled.size();
 }
 
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const size_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+std::vector<std::string> parse(std::string_view input) {
   std::vector<std::string> contraption;
-  while (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
-    contraption.push_back(std::string(line, line_length));
+  for (std::string_view line : Lines{input}) {
+    contraption.push_back(std::string(line));
   }
-  std::cout << std::format(
-      "PART1: {}\n",
-      run_beam(contraption, Coord{.x = 0, .y = 0}, Direction::Right));
-  size_t part2 = 0;
+  return contraption;
+}
+int64_t part1(const std::vector<std::string> &contraption) {
+  return run_beam(contraption, Coord{.x = 0, .y = 0}, Direction::Right);
+}
+int64_t part2(const std::vector<std::string> &contraption) {
+  std::vector<std::pair<Coord, Direction>> starts;
   for (size_t col = 0; col < contraption[0].length(); ++col) {
-    part2 = std::max(part2, run_beam(contraption, Coord{.x = col, .y = 0},
-                                     Direction::Bottom));
+    starts.push_back({Coord{.x = col, .y = 0}, Direction::Bottom});
+    starts.push_back({Coord{.x = col, .y = contraption.size() - 1}, Direction::Top});
   }
   for (size_t row = 0; row < contraption.size(); ++row) {
-    part2 = std::max(part2, run_beam(contraption, Coord{.x = 0, .y = row},
-                                     Direction::Right));
-  }
-  for (size_t row = 0; row < contraption.size(); ++row) {
-    part2 =
-        std::max(part2, run_beam(contraption,
-                                 Coord{.x = contraption[0].length() - 1, .y = row},
-                                 Direction::Left));
-  }
-  for (size_t col = 0; col < contraption[0].length(); ++col) {
-    part2 = std::max(part2, run_beam(contraption, Coord{.x = col, .y = contraption.size() - 1},
-                                     Direction::Top));
+    starts.push_back({Coord{.x = 0, .y = row}, Direction::Right});
+    starts.push_back({Coord{.x = contraption[0].length() - 1, .y = row}, Direction::Left});
   }
-  std::cout << std::format("PART2: {}\n", part2);
-  return 0;
+  // every edge start is independent
+  std::vector<size_t> energized(starts.size());
+  parallel_for(starts.size(), [&](size_t idx) {
+    energized[idx] = run_beam(contraption, starts[idx].first, starts[idx].second);
+  });
+  return (int64_t)*std::max_element(energized.begin(), energized.end());
 }
+} // namespace day16
+AOC_DAY(16, parse, part1, part2)
@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -17,56 +16,11 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day18 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int64_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int64_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -258,31 +212,17 @@ std::ostream &operator<<(std::ostream &os, InsideSide is) {
   }
   return os;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int64_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+std::vector<DigInstruction> parse(std::string_view input) {
   std::vector<DigInstruction> instructions;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int64_t line_length = input.gcount() - 1;
-    std::string line_str(line, line_length);
-    auto idx_of_s = line_str.find(' ', 2);
-    int64_t amt = parse_number(
-        std::string_view(line_str.begin() + 2, line_str.begin() + idx_of_s));
+  for (std::string_view line : Lines{input}) {
+    auto idx_of_s = line.find(' ', 2);
+    int64_t amt = parse_number(line.substr(2, idx_of_s - 2));
     instructions.push_back(DigInstruction(
-        d_from_char(line[0]), amt,
-        std::string(line + idx_of_s + 1, line_length - (idx_of_s + 1))));
+        d_from_char(line[0]), amt, std::string(line.substr(idx_of_s + 1))));
   }
-  input.close();
-
+  return instructions;
+}
+int64_t part1(const std::vector<DigInstruction> &instructions) {
   int64_t row_offset = 0;
   int64_t col_offset = 0;
   std::vector<Coord> coords;
@@ -336,9 +276,9 @@ int32_t main(int32_t argc, char *argv[]) {
   for (const Coord &c : coords) {
     matrix[c.y - min_row][c.x - min_col] = '1';
   }
-  int64_t area = get_area(matrix, max_row, min_row, max_col, min_col);
-  std::cout << std::format("PART1: {}\n", area);
-
+  return get_area(matrix, max_row, min_row, max_col, min_col);
+}
+int64_t part2(const std::vector<DigInstruction> &instructions) {
   int64_t y_offset = 0;
   int64_t x_offset = 0;
   std::vector<std::pair<Coord, std::pair<int64_t, InsideSide>>> vertical;
@@ -734,7 +674,6 @@ int32_t main(int32_t argc, char *argv[]) {
   int64_t part2 = std::accumulate(
       regions.begin(), regions.end(), int64_t{0},
       [](int64_t acc, const auto &r) { return acc + r.get_area(); });
-  std::cout << std::format("PART2: {}\n", part2);
 
   // 0000000000
   // 0        0
@@ -789,5 +728,7 @@ int32_t main(int32_t argc, char *argv[]) {
   //       0    0
   //       000000
 
-  return 0;
+  return part2;
 }
+} // namespace day18
+AOC_DAY(18, parse, part1, part2)
@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -17,56 +16,11 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day19 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int64_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int64_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -198,7 +152,7 @@ struct WorkFlow {
   std::vector<Rule> rules;
   WorkFlow() = default;
   WorkFlow(std::vector<Rule> rs) { rules = rs; }
-  std::string apply_rules(Part p) {
+  std::string apply_rules(Part p) const {
     for (const Rule &rule : rules) {
       if (rule.just_workflow) {
         return rule.workflow;
@@ -320,30 +274,22 @@ std::ostream &operator<<(std::ostream &os, const Rule &r) {
   }
   return os;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int64_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+struct System {
+  std::map<std::string, WorkFlow> workflows;
+  std::vector<Part> parts;
+};
+System parse(std::string_view input) {
   bool begin_parsing_parts = false;
   std::vector<Part> parts;
-  std::vector<Part> accepted;
   std::map<std::string, WorkFlow> workflows;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int64_t line_length = input.gcount() - 1;
+  for (std::string_view line : Lines{input}) {
+    int64_t line_length = (int64_t)line.length();
     if (line_length == 0) {
       begin_parsing_parts = true;
       continue;
     }
     if (begin_parsing_parts) {
-      std::string part_line(line, line_length);
+      std::string part_line(line);
       std::vector<int64_t> categories;
       for (size_t idx = 1; idx < part_line.length();) {
         if (part_line[idx] == 'x' || part_line[idx] == 'm' ||
@@ -366,7 +312,7 @@ int32_t main(int32_t argc, char *argv[]) {
       parts.push_back(
           Part(categories[0], categories[1], categories[2], categories[3]));
     } else {
-      std::string workflow(line, line_length);
+      std::string workflow(line);
       size_t idx_of_first_curly = workflow.find('{');
       std::string workflow_name = workflow.substr(0, idx_of_first_curly);
       std::vector<Rule> rules;
@@ -393,11 +339,14 @@ int32_t main(int32_t argc, char *argv[]) {
       workflows[workflow_name] = WorkFlow(rules);
     }
   }
-  input.close();
-  for (const Part &p : parts) {
+  return System{.workflows = workflows, .parts = parts};
+}
+int64_t part1(const System &system) {
+  std::vector<Part> accepted;
+  for (const Part &p : system.parts) {
     std::string workflow = "in";
     while (workflow != "A" and workflow != "R") {
-      workflow = workflows[workflow].apply_rules(p);
+      workflow = system.workflows.at(workflow).apply_rules(p);
     }
     if (workflow == "A") {
       accepted.push_back(p);
@@ -407,10 +356,11 @@ int32_t main(int32_t argc, char *argv[]) {
   for (const Part &p : accepted) {
     part1 += p.x + p.m + p.a + p.s;
   }
-  std::cout << std::format("PART1: {}\n", part1);
-
+  return part1;
+}
+int64_t part2(const System &system) {
   std::vector<xmas> grouped_together;
-  dfs(workflows, "in", Range(1, 4000), Range(1, 4000), Range(1, 4000),
+  dfs(system.workflows, "in", Range(1, 4000), Range(1, 4000), Range(1, 4000),
       Range(1, 4000), grouped_together);
 
   auto check_for_overlaps = [](xmas &group, xmas &group2) -> bool {
@@ -484,6 +434,7 @@ int32_t main(int32_t argc, char *argv[]) {
             [](int64_t acc, const Range &r) { return acc + r.length; });
         return acc + (xs * ms * as * ss);
       });
-  std::cout << std::format("PART2: {}\n", part2);
-  return 0;
+  return part2;
 }
+} // namespace day19
+AOC_DAY(19, parse, part1, part2)
@@ -1,82 +1,274 @@
 #include <iostream>
-#include <fstream>
-#include <array>
-#include <cmath>
-int32_t max(int32_t a, int32_t b) {
-  return a < b ? b:a;
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+#include "../common/pool.h"
+namespace day2 {
+// Only the most cubes of each colour shown in a game matter for either part,
+// so a game is reduced to that while it is parsed. rgb order.
+struct Game {
+  int32_t id;
+  int32_t red;
+  int32_t green;
+  int32_t blue;
+};
+// One pass over "Game <id>: <n> <colour>, <n> <colour>; ..." lines. Sets and
+// cubes are all folded into the same maximum, so ',' and ';' are treated
+// alike and only the first letter of a colour is looked at.
+template <typename F>
+void for_each_game(std::string_view chunk, F &&emit) {
+  size_t idx = 0;
+  while (idx < chunk.length()) {
+    if (chunk[idx] == '\n') {
+      ++idx;
+      continue;
+    }
+    Game game{0, 0, 0, 0};
+    while (idx < chunk.length() && !is_digit(chunk[idx])) {
+      ++idx;
+    }
+    game.id = (int32_t)parse_digits(chunk, idx);
+    // skip ':'
+    ++idx;
+    while (idx < chunk.length() && chunk[idx] != '\n') {
+      while (idx < chunk.length() && !is_digit(chunk[idx])) {
+        ++idx;
+      }
+      int32_t count = (int32_t)parse_digits(chunk, idx);
+      // skip ' '
+      ++idx;
+      if (idx >= chunk.length()) {
+        break;
+      }
+      switch (chunk[idx]) {
+        case 'r': game.red = std::max(game.red, count); break;
+        case 'g': game.green = std::max(game.green, count); break;
+        case 'b': game.blue = std::max(game.blue, count); break;
+      }
+      while (idx < chunk.length() && chunk[idx] != ',' && chunk[idx] != ';' &&
+             chunk[idx] != '\n') {
+        ++idx;
+      }
+      if (idx < chunk.length() && chunk[idx] != '\n') {
+        ++idx;
+      }
+    }
+    emit(game);
+  }
+}
+// Struct of arrays, so a threshold query is a branch free pass over four
+// plain int32_t arrays that the compiler vectorizes.
+struct GameStore {
+  std::vector<int32_t> ids;
+  std::vector<int32_t> red;
+  std::vector<int32_t> green;
+  std::vector<int32_t> blue;
+  size_t size() const { return ids.size(); }
+};
+GameStore parse(std::string_view input) {
+  // every newline aligned chunk is parsed on the pool, then copied into place
+  std::vector<std::string_view> text = line_chunks(input, 1 << 20);
+  std::vector<std::vector<Game>> chunks(text.size());
+  parallel_for(text.size(), [&](size_t idx) {
+    for_each_game(text[idx], [&](const Game &game) { chunks[idx].push_back(game); });
+  });
+  std::vector<size_t> offsets(chunks.size() + 1, 0);
+  for (size_t idx = 0; idx < chunks.size(); ++idx) {
+    offsets[idx + 1] = offsets[idx] + chunks[idx].size();
+  }
+  GameStore store;
+  store.ids.resize(offsets.back());
+  store.red.resize(offsets.back());
+  store.green.resize(offsets.back());
+  store.blue.resize(offsets.back());
+  parallel_for(chunks.size(), [&](size_t idx) {
+    for (size_t game = 0; game < chunks[idx].size(); ++game) {
+      store.ids[offsets[idx] + game] = chunks[idx][game].id;
+      store.red[offsets[idx] + game] = chunks[idx][game].red;
+      store.green[offsets[idx] + game] = chunks[idx][game].green;
+      store.blue[offsets[idx] + game] = chunks[idx][game].blue;
+    }
+  });
+  return store;
+}
+// f(begin, end) over blocks of the store, summed on the pool
+template <typename F>
+int64_t sum_blocks(const GameStore &store, F &&f) {
+  constexpr size_t block = 1 << 16;
+  size_t blocks = (store.size() + block - 1) / block;
+  return parallel_sum(blocks, [&](size_t idx) {
+    return f(idx * block, std::min(store.size(), (idx + 1) * block));
+  });
+}
+
+// the most cubes of each colour the bag holds
+struct Limits {
+  int32_t red;
+  int32_t green;
+  int32_t blue;
+};
+int64_t possible_id_sum(const GameStore &store, size_t begin, size_t end, Limits limits) {
+  int64_t sum = 0;
+  for (size_t idx = begin; idx < end; ++idx) {
+    bool possible = (store.red[idx] <= limits.red) & (store.green[idx] <= limits.green) &
+                    (store.blue[idx] <= limits.blue);
+    sum += possible ? store.ids[idx] : 0;
+  }
+  return sum;
 }
-// returned results will always be rgb
-std::array<int32_t, 3> parse_set(char *set, int32_t length) {
-  int32_t red = 0;
-  int32_t green = 0;
-  int32_t blue = 0;
-  int32_t start_idx = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    if (set[idx] == ' ' && set[idx + 1] >= 97 && set[idx + 1] <= 123) {
-      int32_t val = 0;
-      for (int32_t digit_idx = start_idx; digit_idx < idx; ++digit_idx) {
-        val += (set[digit_idx] - '0') * std::pow(10, (idx - digit_idx - 1));
+// Sum of the ids of the games that fit within (r, g, b) for every r, g, b up
+// to the largest count seen, a 3D prefix sum. Counts are small, so the cube
+// is too, and after building it once every query is one lookup.
+struct DominanceIndex {
+  int32_t size_red = 0;
+  int32_t size_green = 0;
+  int32_t size_blue = 0;
+  std::vector<int64_t> sums;
+  int64_t &at(int32_t r, int32_t g, int32_t b) {
+    return sums[((size_t)r * (size_t)size_green + (size_t)g) * (size_t)size_blue + (size_t)b];
+  }
+  int64_t query(Limits limits) {
+    if (limits.red < 0 || limits.green < 0 || limits.blue < 0) {
+      return 0;
+    }
+    return at(std::min(limits.red, size_red - 1), std::min(limits.green, size_green - 1),
+              std::min(limits.blue, size_blue - 1));
+  }
+};
+DominanceIndex build_dominance_index(const GameStore &store) {
+  DominanceIndex index;
+  index.size_red = *std::max_element(store.red.begin(), store.red.end()) + 1;
+  index.size_green = *std::max_element(store.green.begin(), store.green.end()) + 1;
+  index.size_blue = *std::max_element(store.blue.begin(), store.blue.end()) + 1;
+  index.sums.resize((size_t)index.size_red * (size_t)index.size_green * (size_t)index.size_blue);
+  for (size_t idx = 0; idx < store.size(); ++idx) {
+    index.at(store.red[idx], store.green[idx], store.blue[idx]) += store.ids[idx];
+  }
+  for (int32_t r = 0; r < index.size_red; ++r) {
+    for (int32_t g = 0; g < index.size_green; ++g) {
+      for (int32_t b = 0; b < index.size_blue; ++b) {
+        int64_t &sum = index.at(r, g, b);
+        if (r > 0) {
+          sum += index.at(r - 1, g, b);
+        }
+        if (g > 0) {
+          sum += index.at(r, g - 1, b);
+        }
+        if (b > 0) {
+          sum += index.at(r, g, b - 1);
+        }
+        if (r > 0 && g > 0) {
+          sum -= index.at(r - 1, g - 1, b);
+        }
+        if (r > 0 && b > 0) {
+          sum -= index.at(r - 1, g, b - 1);
+        }
+        if (g > 0 && b > 0) {
+          sum -= index.at(r, g - 1, b - 1);
+        }
+        if (r > 0 && g > 0 && b > 0) {
+          sum += index.at(r - 1, g - 1, b - 1);
+        }
       }
-      switch (set[idx + 1]) {
-        case 'r': red = val;break; 
-        case 'g': green = val;break;
-        case 'b': blue = val;break;
+    }
+  }
+  return index;
+}
+// Few queries are each a filter pass over the store. With many, the
+// dominance index pays for itself unless the counts are huge.
+std::vector<int64_t> possible_id_sums(const GameStore &store, const std::vector<Limits> &queries) {
+  std::vector<int64_t> sums(queries.size(), 0);
+  if (store.size() == 0) {
+    return sums;
+  }
+  if (queries.size() >= 16) {
+    // the cube has (max + 1) cells along each colour; multiplied one at a
+    // time against the budget so the product cannot overflow
+    constexpr int64_t budget = 1 << 24;
+    int64_t cells = 1;
+    for (const std::vector<int32_t> *counts : {&store.red, &store.green, &store.blue}) {
+      int64_t size = (int64_t)*std::max_element(counts->begin(), counts->end()) + 1;
+      cells = cells > budget / size ? budget + 1 : cells * size;
+    }
+    if (cells <= budget) {
+      DominanceIndex index = build_dominance_index(store);
+      for (size_t idx = 0; idx < queries.size(); ++idx) {
+        sums[idx] = index.query(queries[idx]);
       }
-    } else if (set[idx] == ',') {
-      start_idx = idx + 2;
+      return sums;
     }
   }
-  return {red, green, blue};
+  for (size_t idx = 0; idx < queries.size(); ++idx) {
+    sums[idx] = sum_blocks(store, [&](size_t begin, size_t end) {
+      return possible_id_sum(store, begin, end, queries[idx]);
+    });
+  }
+  return sums;
 }
-int32_t main() {
+
+int64_t part1(const GameStore &store) {
   //A game is impossible if at any point in any game, the number of cubes of any color exceeds 12 red, 13 green, 14 blue.
   //A game is possible if all sets have less than or equal to 12 red, 13 green, 14 blue.
-  std::ifstream input("day2_input.txt");
-  if (!input.is_open()) {
-    std::cerr << "Unable to open file" << std::endl;
-    return 1;
-  }
-  int32_t sum_of_game_ids = 0;
-  int32_t sum_of_rgb_multiplied = 0;
-  char line[500];
-  int32_t game_id = 0;
-  while (input.getline(line, 500)) {
-    ++game_id;
-    int32_t line_length = input.gcount();
-    int32_t idx_of_colon = 0;
-    for (int32_t idx = 0; idx < line_length; ++idx) {
-      if (line[idx] == ':') {
-        idx_of_colon = idx;
-        break;
-      }
+  return sum_blocks(store, [&](size_t begin, size_t end) {
+    return possible_id_sum(store, begin, end, Limits{12, 13, 14});
+  });
+}
+int64_t part2(const GameStore &store) {
+  return sum_blocks(store, [&](size_t begin, size_t end) {
+    int64_t sum_of_rgb_multiplied = 0;
+    for (size_t idx = begin; idx < end; ++idx) {
+      sum_of_rgb_multiplied += (int64_t)store.red[idx] * store.green[idx] * store.blue[idx];
     }
-    int32_t idx_of_start_of_sets = idx_of_colon;
-    int32_t prev_idx_of_semi = idx_of_start_of_sets;
-    bool add = true;
-    int32_t max_red = 0;
-    int32_t max_green = 0;
-    int32_t max_blue = 0;
-    for (int32_t idx = idx_of_start_of_sets; idx < line_length; ++idx) {
-      if (line[idx] == ';' || idx == line_length - 1) {
-        if (idx == line_length - 1) {
-          idx = line_length;
-        }
-        // adding 2 because of semi and space
-        std::array<int32_t, 3> rgb = parse_set(line + prev_idx_of_semi + 2, idx - (prev_idx_of_semi + 2));
-        max_red = max(rgb[0], max_red);
-        max_green = max(rgb[1], max_green);
-        max_blue = max(rgb[2], max_blue);
-        if (rgb[0] > 12 || rgb[1] > 13 || rgb[2] > 14) {
-          add = false;
+    return sum_of_rgb_multiplied;
+  });
+}
+// ./day2 input.txt --limits R,G,B ... [--queries file]
+// answers part 1 for other bags; a queries file has one "r g b" per line
+int32_t what_if(const char *path, const std::vector<std::string_view> &args) {
+  std::vector<Limits> queries;
+  auto add_query = [&](std::string_view text) {
+    int64_t rgb[3];
+    char delimiter = text.find(',') == std::string_view::npos ? ' ' : ',';
+    if (parse_numbers(text, rgb, delimiter) != 3) {
+      return false;
+    }
+    queries.push_back(Limits{(int32_t)rgb[0], (int32_t)rgb[1], (int32_t)rgb[2]});
+    return true;
+  };
+  for (size_t idx = 0; idx < args.size(); ++idx) {
+    if (args[idx] == "--limits" && idx + 1 < args.size() && add_query(args[idx + 1])) {
+      ++idx;
+    } else if (args[idx] == "--queries" && idx + 1 < args.size()) {
+      InputFile file(std::string(args[++idx]).c_str());
+      if (!file.is_open()) {
+        std::cerr << args[idx] << " file cannot be opened\n";
+        return 1;
+      }
+      for (std::string_view line : file.lines()) {
+        if (!line.empty() && !add_query(line)) {
+          std::cerr << "bad query: " << line << "\n";
+          return 1;
         }
-        prev_idx_of_semi = idx;
       }
+    } else {
+      std::cerr << "day2 options: --limits R,G,B ... --queries file\n";
+      return 1;
     }
-    if (add)
-      sum_of_game_ids += game_id;
-    sum_of_rgb_multiplied += max_red * max_green * max_blue;
   }
-  input.close();
-  std::cout << "PART1: " << sum_of_game_ids << std::endl;
-  std::cout << "PART2: " << sum_of_rgb_multiplied << std::endl;
+  InputFile input(path);
+  if (!input.is_open()) {
+    std::cerr << path << " file cannot be opened\n";
+    return 1;
+  }
+  std::vector<int64_t> sums = possible_id_sums(parse(input.contents()), queries);
+  for (size_t idx = 0; idx < queries.size(); ++idx) {
+    std::cout << queries[idx].red << " " << queries[idx].green << " " << queries[idx].blue
+              << " " << sums[idx] << "\n";
+  }
+  return 0;
 }
+} // namespace day2
+AOC_DAY_COMMAND(2, parse, part1, part2, what_if)
@@ -4,9 +4,9 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <optional>
 #include <queue>
@@ -17,56 +17,11 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day20 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int64_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int64_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -171,7 +126,7 @@ struct Module {
   virtual void receive(Pulse) = 0;
   virtual void receive(std::string, Pulse){};
   Module() = default;
-  ~Module() = default;
+  virtual ~Module() = default;
 };
 struct FlipFlop : public Module {
   bool did_nothing;
@@ -298,40 +253,43 @@ struct UntypedModule : public Module {
   }
   ~UntypedModule() = default;
 };
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int64_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+std::vector<std::string> parse(std::string_view input) {
   std::vector<std::string> modules_strings;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int64_t line_length = input.gcount() - 1;
-    modules_strings.push_back(std::string(line, line_length));
+  for (std::string_view line : Lines{input}) {
+    modules_strings.push_back(std::string(line));
   }
-  input.close();
-
+  return modules_strings;
+}
+// both parts push buttons on live module state, so each builds its own machine;
+// owned holds every module, the other lists only point into it
+struct Machine {
+  std::vector<std::unique_ptr<Module>> owned;
+  std::vector<Module *> modules;
+  std::vector<FlipFlop *> ffs;
+  std::vector<Conjunction *> cs;
+};
+Machine build_machine(const std::vector<std::string> &modules_strings) {
+  std::vector<std::unique_ptr<Module>> owned;
+  auto own = [&owned]<typename M>(std::unique_ptr<M> module) {
+    M *m = module.get();
+    owned.push_back(std::move(module));
+    return m;
+  };
   std::vector<Module *> modules;
   std::vector<FlipFlop *> ffs;
   std::vector<Conjunction *> cs;
   for (const std::string &ms : modules_strings) {
     size_t pos_of_arrow = ms.find(" -> ");
     if (ms[0] == '%') {
-      FlipFlop *ff = new FlipFlop(ms.substr(1, pos_of_arrow - 1));
+      FlipFlop *ff = own(std::make_unique<FlipFlop>(ms.substr(1, pos_of_arrow - 1)));
       modules.push_back(ff);
       ffs.push_back(ff);
     } else if (ms[0] == '&') {
-      Conjunction *c = new Conjunction(ms.substr(1, pos_of_arrow - 1));
+      Conjunction *c = own(std::make_unique<Conjunction>(ms.substr(1, pos_of_arrow - 1)));
       modules.push_back(c);
       cs.push_back(c);
     } else {
-      modules.push_back(new Broadcaster());
+      modules.push_back(own(std::make_unique<Broadcaster>()));
     }
   }
   for (const std::string &ms : modules_strings) {
@@ -368,7 +326,7 @@ int32_t main(int32_t argc, char *argv[]) {
                        [&msv](const Module *m) { return m->name == msv; });
 
       if (output_find == modules.end()) {
-        (*module_find)->outputs.push_back(new UntypedModule(std::string(msv)));
+        (*module_find)->outputs.push_back(own(std::make_unique<UntypedModule>(std::string(msv))));
       } else {
         // auto circular_fd = std::find_if((*output_find)->outputs.begin(),
         //                              (*output_find)->outputs.end(),
@@ -392,23 +350,15 @@ int32_t main(int32_t argc, char *argv[]) {
       c->memory.push_back({m->name, Pulse::Low});
     }
   }
+  return Machine{.owned = std::move(owned), .modules = modules, .ffs = ffs, .cs = cs};
+}
+int64_t part1(const std::vector<std::string> &modules_strings) {
+  auto [owned, modules, ffs, cs] = build_machine(modules_strings);
   auto broadcaster =
       std::find_if(modules.begin(), modules.end(),
                    [](const Module *m) { return m->name == "broadcaster"; });
   std::queue<Module *> sends;
   const size_t PUSH_LIMIT = 1'000;
-  auto fd = std::find_if(cs.begin(), cs.end(), [](const Conjunction *m) {
-    return m->name == "zh";
-  });
-  assert(fd != cs.end());
-  for (const Module *m : (*fd)->inputs) {
-    std::cout << m->name << " ";
-    if (m->mt == ModuleType::FlipFlop) {
-      std::cout << "FlipFlop" << std::endl;
-    } else if (m->mt == ModuleType::Conjunction) {
-      std::cout << "Conjunction" << std::endl;
-    }
-  }
   for (size_t push = 0; push < PUSH_LIMIT; ++push) {
     sends.push(*broadcaster);
     while (!sends.empty()) {
@@ -436,13 +386,14 @@ int32_t main(int32_t argc, char *argv[]) {
   int64_t total_high = std::accumulate(
       modules.begin(), modules.end(), int64_t{0},
       [](int64_t acc, const Module *m) { return acc + m->high_sent; });
-  std::cout << "PART1: " << (total_low + PUSH_LIMIT) * (total_high)
-            << std::endl;
-
-  for (Module *m : modules) {
-    m->reset();
-  }
-  assert(sends.empty());
+  return (total_low + (int64_t)PUSH_LIMIT) * (total_high);
+}
+int64_t part2(const std::vector<std::string> &modules_strings) {
+  auto [owned, modules, ffs, cs] = build_machine(modules_strings);
+  auto broadcaster =
+      std::find_if(modules.begin(), modules.end(),
+                   [](const Module *m) { return m->name == "broadcaster"; });
+  std::queue<Module *> sends;
   for (const Module *m : modules) {
     if (m->name == "broadcaster") continue;
     bool is_connected = false;
@@ -481,7 +432,6 @@ int32_t main(int32_t argc, char *argv[]) {
       o->send();
       for (Module *m : o->outputs) {
         if (o->prev_sent_pulse == Pulse::Low && m->mt == ModuleType::Untyped) {
-          std::cerr << m->name << std::endl;
           final_machine_on = true;
           break;
         }
@@ -499,6 +449,7 @@ int32_t main(int32_t argc, char *argv[]) {
       }
     }
   }
-  std::cout << "PART2: " << push_amt << std::endl;
-  return 0;
+  return (int64_t)push_amt;
 }
+} // namespace day20
+AOC_DAY(20, parse, part1, part2)
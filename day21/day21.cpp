@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -17,56 +16,11 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day21 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int64_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int64_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -126,26 +80,15 @@ struct Region {
     bottom_right = four;
   }
 };
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int64_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+struct Garden {
+  std::vector<std::string> map;
+  Coord s;
+};
+Garden parse(std::string_view input) {
   std::vector<std::string> map;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int64_t line_length = input.gcount() - 1;
-    map.push_back(std::string(line, line_length));
+  for (std::string_view line : Lines{input}) {
+    map.push_back(std::string(line));
   }
-  input.close();
-
-  auto map2 = map;
 
   auto find_s_loc = [](const std::vector<std::string> &map) -> Coord {
     Coord s;
@@ -162,8 +105,11 @@ int32_t main(int32_t argc, char *argv[]) {
 
   Coord s = find_s_loc(map);
   map[s.y][s.x] = '.';
-  map2[s.y][s.x] = '.';
-
+  return Garden{.map = map, .s = s};
+}
+int64_t part1(const Garden &garden) {
+  std::vector<std::string> map = garden.map;
+  Coord s = garden.s;
   {
     std::queue<Coord> q;
     q.push(s);
@@ -192,8 +138,12 @@ int32_t main(int32_t argc, char *argv[]) {
         --q_size;
       }
     }
-    std::cout << "PART1: " << q.size() << std::endl;
+    return (int64_t)q.size();
   }
+}
+int64_t part2(const Garden &garden) {
+  const std::vector<std::string> &map2 = garden.map;
+  Coord s = garden.s;
   {
     std::queue<Coord> q;
     q.push(s);
@@ -201,7 +151,6 @@ int32_t main(int32_t argc, char *argv[]) {
     in_q.insert({s.x, s.y});
     const size_t STEP_LIMIT = 1244 + 131 - 131 - 131;
     int64_t current_quad = 4;
-    int64_t prev_d = 0;
     const int64_t ACTUAL_LIMIT = 26'501'365;
     std::vector<int64_t> stupid_step(ACTUAL_LIMIT, 0);
     std::vector<int64_t> stupid_diff(ACTUAL_LIMIT, 0);
@@ -272,12 +221,8 @@ int32_t main(int32_t argc, char *argv[]) {
         }
         --q_size;
       }
-      std::cout << steps << " " << q.size() << " " << current_quad << " "
-                << (int64_t)q.size() - current_quad << " "
-                << (int64_t)q.size() - current_quad - prev_d << std::endl;
       stupid_step[steps] = q.size();
       stupid_diff[steps] = (int64_t)q.size() - current_quad;
-      prev_d = (int64_t)q.size() - current_quad;
       current_quad += 4;
     }
     int64_t start = 0;
@@ -294,10 +239,8 @@ int32_t main(int32_t argc, char *argv[]) {
         }
       }
     }
-    std::cout << start << " " << end << std::endl;
     int64_t start2 = end;
     int64_t end2 = end + 131;
-    std::cout << start2 << " " << end2 << std::endl;
     std::vector<int64_t> diffs_offset(131, 0);
     for (int64_t idx = start2; idx < end2; ++idx) {
       diffs_offset[idx - start2] =
@@ -326,10 +269,11 @@ int32_t main(int32_t argc, char *argv[]) {
       sum += stupid_step[idx];
       assert(sum >= 0);
     }
-    std::cout << "PART2: " << sum << std::endl;
+    return sum;
   }
-  return 0;
 }
+} // namespace day21
+AOC_DAY(21, parse, part1, part2)
 
 //     4
 /*    434
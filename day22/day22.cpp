@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -17,56 +16,11 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day22 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int64_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int64_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -128,33 +82,32 @@ struct Region {
 };
 typedef std::tuple<int64_t, int64_t, int64_t> BrickEnd;
 typedef std::pair<BrickEnd, BrickEnd> Brick;
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int64_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+std::vector<Brick> parse(std::string_view input) {
   std::vector<Brick> bricks;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int64_t line_length = input.gcount() - 1;
-    std::string line_str(line, line_length);
-    size_t pos = line_str.find('~');
-    auto v = parse_string_to_vec_numbers(line, pos, ',');
-    assert(v.size() == 3);
+  for (std::string_view line : Lines{input}) {
+    size_t pos = line.find('~');
+    // both ends need all three coordinates; other lines are skipped
+    std::array<int64_t, 3> v{};
+    std::array<int64_t, 3> v2{};
+    if (pos == std::string_view::npos || parse_numbers(line.substr(0, pos), v, ',') != 3 ||
+        parse_numbers(line.substr(pos + 1), v2, ',') != 3) {
+      continue;
+    }
     BrickEnd be1{v[0], v[1], v[2]};
-    auto v2 = parse_string_to_vec_numbers(line + pos + 1,
-                                          line_length - (pos + 1), ',');
     BrickEnd be2{v2[0], v2[1], v2[2]};
     bricks.push_back({be1, be2});
   }
-  input.close();
-
+  return bricks;
+}
+// bricks after they have all fallen, with falling[x][y][max_z_overall + 1 - z]
+// holding the number of the brick in that cell
+struct Settled {
+  std::vector<Brick> bricks;
+  std::vector<std::vector<std::vector<int64_t>>> falling;
+  int64_t max_z_overall;
+  size_t brick_number;
+};
+Settled settle(std::vector<Brick> bricks) {
   int64_t min_z_overall = 1'000'000;
   int64_t max_z_overall = -1'000'000;
   int64_t min_y_overall = 1'000'000;
@@ -273,6 +226,16 @@ int32_t main(int32_t argc, char *argv[]) {
       assert(bricks_under.size() > 0);
     }
   }
+  return Settled{.bricks = bricks,
+                 .falling = falling,
+                 .max_z_overall = max_z_overall,
+                 .brick_number = brick_number};
+}
+int64_t part1(const std::vector<Brick> &input) {
+  Settled settled = settle(input);
+  const std::vector<Brick> &bricks = settled.bricks;
+  const auto &falling = settled.falling;
+  const int64_t max_z_overall = settled.max_z_overall;
   // for (const Brick &b : bricks) {
   //   std::cout << std::get<0>(b.first) << " " << std::get<1>(b.first) << " "
   //             << std::get<2>(b.first) << std::endl;
@@ -282,7 +245,7 @@ int32_t main(int32_t argc, char *argv[]) {
   // }
   //  brick numbers that cannot be disintegrated
   std::set<size_t> brick_numbers;
-  for (size_t bn : std::views::iota((size_t)1, brick_number)) {
+  for (size_t bn : std::views::iota((size_t)1, settled.brick_number)) {
     brick_numbers.insert(bn);
   }
   for (const Brick &b : bricks) {
@@ -311,8 +274,13 @@ int32_t main(int32_t argc, char *argv[]) {
       brick_numbers.erase(cannot);
     }
   }
-  std::cout << "PART1: " << brick_numbers.size() << std::endl;
-
+  return (int64_t)brick_numbers.size();
+}
+int64_t part2(const std::vector<Brick> &input) {
+  Settled settled = settle(input);
+  const std::vector<Brick> &bricks = settled.bricks;
+  const auto &falling = settled.falling;
+  const int64_t max_z_overall = settled.max_z_overall;
   std::map<int64_t, Brick> num_to_brick;
   for (const Brick &b : bricks) {
     int64_t min_z = std::min({std::get<2>(b.first), std::get<2>(b.second)});
@@ -441,6 +409,7 @@ int32_t main(int32_t argc, char *argv[]) {
     }
     part2 += moved;
   }
-  std::cout << "PART2: " << part2 << std::endl;
-  return 0;
+  return part2;
 }
+} // namespace day22
+AOC_DAY(22, parse, part1, part2)
@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cstdint>
 #include <format>
-#include <fstream>
 #include <functional>
 #include <iostream>
 #include <iterator>
@@ -20,56 +19,11 @@
 #include <unistd.h>
 #include <utility>
 #include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day23 {
 
-int64_t parse_number(std::string_view s) {
-  int32_t length = (int32_t)s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * (int64_t)std::pow(10, length - idx - 1);
-  }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int64_t length,
-                                                 char delimiter = ' ') {
-  std::vector<int64_t> numbers;
-  enum class Sign {
-    Pos,
-    Neg,
-  };
-  std::vector<std::pair<Sign, std::string_view>> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int64_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (((line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9') ||
-         line[num_parser_idx] == '-') &&
-        !digit_start.has_value()) {
-      digit_start = num_parser_idx;
-    }
-    if ((line[num_parser_idx] == delimiter || num_parser_idx == length - 1) &&
-        digit_start.has_value()) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      bool has_neg = line[*digit_start] == '-';
-      int32_t actual_digit_start = has_neg ? *digit_start + 1 : *digit_start;
-      num_strings.push_back(
-          {has_neg ? Sign::Neg : Sign::Pos,
-           std::string_view(line + actual_digit_start,
-                            num_parser_idx - actual_digit_start)});
-      digit_start.reset();
-    }
-  }
-  for (auto [sign, seed_str] : num_strings) {
-    auto num = parse_number(seed_str);
-    switch (sign) {
-    case Sign::Pos:
-      numbers.push_back(num);
-      break;
-    case Sign::Neg:
-      numbers.push_back(-num);
-      break;
-    }
-  }
-  return numbers;
-}
 template <typename T>
   requires std::is_integral_v<T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
@@ -147,25 +101,14 @@ std::ostream &operator<<(std::ostream &os, const std::pair<A, B> &p) {
   os << p.first << " " << p.second;
   return os;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
-  }
-  const int64_t LINE_CAPACITY = 1 << 16;
-  char line[LINE_CAPACITY];
+std::vector<std::string> parse(std::string_view input) {
   std::vector<std::string> hiking_trails;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int64_t line_length = input.gcount() - 1;
-    hiking_trails.push_back(std::string(line, line_length));
+  for (std::string_view line : Lines{input}) {
+    hiking_trails.push_back(std::string(line));
   }
-  input.close();
-
+  return hiking_trails;
+}
+int64_t part1(const std::vector<std::string> &hiking_trails) {
   Point start(1, 0, 0);
   start.add({0, 1});
   assert(
@@ -250,8 +193,11 @@ int32_t main(int32_t argc, char *argv[]) {
         points.push(next);
       }
     }
-    std::cout << "PART1: " << ans << std::endl;
+    return ans;
   }
+}
+int64_t part2(const std::vector<std::string> &input) {
+  std::vector<std::string> hiking_trails = input;
   for (size_t row = 0; row < hiking_trails.size(); ++row) {
     for (size_t col = 0; col < hiking_trails[row].length(); ++col) {
       if (hiking_trails[row][col] == 'v' || hiking_trails[row][col] == '^' ||
@@ -450,7 +396,8 @@ int32_t main(int32_t argc, char *argv[]) {
         };
     int64_t ans = 0;
     dfs_ans(starting, starting_w, {starting}, ans);
-    std::cout << "PART2: " << ans << std::endl;
+    return ans;
   }
-  return 0;
 }
+} // namespace day23
+AOC_DAY(23, parse, part1, part2)
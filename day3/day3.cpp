@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
-#include <fstream>
+#include <string>
 #include <vector>
 #include <optional>
-#include <cmath>
+#include <tuple>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/line_stream.h"
+#include "../common/parse.h"
+namespace day3 {
 struct Number_Info {
   int32_t row;
   int32_t col;
@@ -11,23 +18,43 @@ struct Number_Info {
   Number_Info(int32_t r, int32_t c, int32_t nd, int32_t num): row{r}, col{c}, number_of_digits{nd}, number{num}
   {}
 };
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "Needs to be called like `./day.out input.txt`\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << "Cannot open file\n";
-    return 1;
-  }
-  char line[256];
+// owner holds, for every cell of the grid, the index of the number written
+// there or -1, so the numbers around a symbol are its 8 neighbouring cells.
+struct Schematic {
   std::vector<Number_Info> numbers;
   std::vector<std::tuple<int32_t, int32_t, char>> symbols;
+  int32_t width = 0;
+  int32_t height = 0;
+  std::vector<int32_t> owner;
+  int32_t owner_at(int32_t row, int32_t col) const {
+    if (row < 0 || row >= height || col < 0 || col >= width) {
+      return -1;
+    }
+    return owner[(size_t)row * (size_t)width + (size_t)col];
+  }
+  // distinct numbers next to (row, col), returns how many were written
+  int32_t adjacent_numbers(int32_t row, int32_t col, int32_t (&ids)[8]) const {
+    int32_t count = 0;
+    for (int32_t dr = -1; dr <= 1; ++dr) {
+      for (int32_t dc = -1; dc <= 1; ++dc) {
+        int32_t id = owner_at(row + dr, col + dc);
+        // a number covers consecutive cells of one row, so a repeat is always
+        // the cell just left of this one
+        if (id >= 0 && (dc == -1 || owner_at(row + dr, col + dc - 1) != id)) {
+          ids[count++] = id;
+        }
+      }
+    }
+    return count;
+  }
+};
+Schematic parse(std::string_view input) {
+  Schematic schematic;
+  std::vector<Number_Info> &numbers = schematic.numbers;
+  std::vector<std::tuple<int32_t, int32_t, char>> &symbols = schematic.symbols;
   int32_t line_number = 0;
-  while (input.getline(line, 256)) {
-    // minus 1 because null termination character
-    int32_t line_length = input.gcount() - 1;
+  for (std::string_view line : Lines{input}) {
+    int32_t line_length = (int32_t)line.length();
     std::optional<int32_t> digit_start;
     for (int32_t line_idx = 0; line_idx < line_length; ++line_idx) {
       if (line[line_idx] >= '0' && line[line_idx] <= '9' && !digit_start.has_value()) {
@@ -35,14 +62,11 @@ int32_t main(int32_t argc, char *argv[]) {
       }
       if (line[line_idx] < '0' || line[line_idx] > '9' || line_idx == line_length - 1) {
         if (digit_start.has_value()) {
-          int32_t number = 0;
           int32_t digit_end =
             line_idx == line_length - 1 &&
             line[line_idx] >= '0' && line[line_idx] <= '9' ? line_length : line_idx;
-          for (int32_t digit_idx = *digit_start; digit_idx < digit_end; ++digit_idx) {
-            number += (line[digit_idx] - '0') * std::pow(10, digit_end - digit_idx - 1);
-          }
-          numbers.push_back(Number_Info(line_number, *digit_start, line_idx - *digit_start, number));
+          int32_t number = (int32_t)parse_number(line.substr(*digit_start, digit_end - *digit_start));
+          numbers.push_back(Number_Info(line_number, *digit_start, digit_end - *digit_start, number));
           digit_start.reset();
         }
         if (line[line_idx] != '.' && (line[line_idx] < '0' || line[line_idx] > '9')) {
@@ -51,43 +75,143 @@ int32_t main(int32_t argc, char *argv[]) {
       }
     }
     line_number += 1;
+    schematic.width = std::max(schematic.width, line_length);
   }
-  int32_t part1_ans = 0;
-  for (Number_Info &ni : numbers) {
-    for (std::tuple<int32_t, int32_t, char> &t : symbols) {
-      int32_t symbol_row = std::get<0>(t);
-      int32_t symbol_col = std::get<1>(t);
-      if (
-        symbol_col >= ni.col - 1 && symbol_col <= (ni.col + ni.number_of_digits - 1) + 1 &&
-        (symbol_row == ni.row || symbol_row - 1 == ni.row || symbol_row + 1 == ni.row)
-        ) {
-        part1_ans += ni.number;
+  schematic.height = line_number;
+  schematic.owner.assign((size_t)schematic.width * (size_t)schematic.height, -1);
+  for (int32_t idx = 0; idx < (int32_t)numbers.size(); ++idx) {
+    const Number_Info &ni = numbers[idx];
+    for (int32_t col = ni.col; col < ni.col + ni.number_of_digits; ++col) {
+      schematic.owner[(size_t)ni.row * (size_t)schematic.width + (size_t)col] = idx;
+    }
+  }
+  return schematic;
+}
+int64_t part1(const Schematic &schematic) {
+  int64_t part1_ans = 0;
+  std::vector<bool> is_part(schematic.numbers.size(), false);
+  for (const std::tuple<int32_t, int32_t, char> &t : schematic.symbols) {
+    int32_t ids[8];
+    int32_t count = schematic.adjacent_numbers(std::get<0>(t), std::get<1>(t), ids);
+    for (int32_t idx = 0; idx < count; ++idx) {
+      is_part[ids[idx]] = true;
+    }
+  }
+  for (size_t idx = 0; idx < schematic.numbers.size(); ++idx) {
+    if (is_part[idx]) {
+      part1_ans += schematic.numbers[idx].number;
+    }
+  }
+  return part1_ans;
+}
+int64_t part2(const Schematic &schematic) {
+  int64_t part2_sum = 0;
+  for (const std::tuple<int32_t, int32_t, char> &t : schematic.symbols) {
+    if (std::get<2>(t) != '*')
+      continue;
+    int32_t ids[8];
+    if (schematic.adjacent_numbers(std::get<0>(t), std::get<1>(t), ids) == 2) {
+      part2_sum += (int64_t)schematic.numbers[ids[0]].number * schematic.numbers[ids[1]].number;
+    }
+  }
+  return part2_sum;
+}
+
+// Streaming mode, for schematics too tall to hold: rows come from a
+// LineStream and only three are kept, in a ring. Row r is settled once row
+// r + 1 has been read, since that completes the neighbourhood of everything
+// in it, so memory is O(width) however many rows there are.
+struct Row {
+  std::string text;
+  // sorted by col, row is unused
+  std::vector<Number_Info> numbers;
+};
+void scan_row(std::string_view line, Row &row) {
+  row.text.assign(line);
+  row.numbers.clear();
+  size_t idx = 0;
+  while (idx < line.length()) {
+    if (!is_digit(line[idx])) {
+      ++idx;
+      continue;
+    }
+    size_t start = idx;
+    int32_t number = (int32_t)parse_digits(line, idx);
+    row.numbers.push_back(Number_Info(0, (int32_t)start, (int32_t)(idx - start), number));
+  }
+}
+bool is_symbol(const Row &row, int32_t col) {
+  if (col < 0 || col >= (int32_t)row.text.length()) {
+    return false;
+  }
+  char c = row.text[col];
+  return c != '.' && !is_digit(c);
+}
+struct Totals {
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+};
+void settle_row(const Row &above, const Row &row, const Row &below, Totals &totals) {
+  for (const Number_Info &ni : row.numbers) {
+    for (int32_t col = ni.col - 1; col <= ni.col + ni.number_of_digits; ++col) {
+      if (is_symbol(above, col) || is_symbol(row, col) || is_symbol(below, col)) {
+        totals.part1 += ni.number;
         break;
       }
     }
   }
-  int32_t part2_sum = 0;
-  for (std::tuple<int32_t, int32_t, char> &t : symbols) {
-    if (std::get<2>(t) != '*')
+  for (int32_t col = 0; col < (int32_t)row.text.length(); ++col) {
+    if (row.text[col] != '*') {
       continue;
-    int32_t symbol_row = std::get<0>(t);
-    int32_t symbol_col = std::get<1>(t);
-    int32_t adjacent_counter = 0;
-    int32_t product = 1;
-    for (Number_Info &ni : numbers) {
-      if (
-        symbol_col >= ni.col - 1 && symbol_col <= (ni.col + ni.number_of_digits - 1) + 1 &&
-        (symbol_row == ni.row || symbol_row - 1 == ni.row || symbol_row + 1 == ni.row)
-        ) {
-        adjacent_counter += 1;
-        product *= ni.number;
+    }
+    int32_t count = 0;
+    int64_t product = 1;
+    for (const Row *r : {&above, &row, &below}) {
+      // first number that reaches col, then every one that starts by col + 1
+      auto it = std::partition_point(r->numbers.begin(), r->numbers.end(),
+                                     [col](const Number_Info &ni) {
+                                       return ni.col + ni.number_of_digits < col;
+                                     });
+      for (; it != r->numbers.end() && it->col <= col + 1; ++it) {
+        ++count;
+        product *= it->number;
       }
     }
-    if (adjacent_counter == 2) {
-      part2_sum += product;
+    if (count == 2) {
+      totals.part2 += product;
+    }
+  }
+}
+// ./day3 input.txt --stream
+int32_t stream(const char *path, const std::vector<std::string_view> &args) {
+  if (args.size() != 1 || args[0] != "--stream") {
+    std::cerr << "day3 options: --stream\n";
+    return 1;
+  }
+  LineStream lines(path);
+  if (!lines.is_open()) {
+    std::cerr << path << " file cannot be opened\n";
+    return 1;
+  }
+  // rows[(r + 3) % 3] is row r, row -1 and the row after the last are empty
+  std::array<Row, 3> rows;
+  Totals totals;
+  size_t row = 0;
+  std::string_view line;
+  while (lines.next(line)) {
+    scan_row(line, rows[row % 3]);
+    if (row > 0) {
+      settle_row(rows[(row + 1) % 3], rows[(row - 1) % 3], rows[row % 3], totals);
     }
+    ++row;
+  }
+  if (row > 0) {
+    scan_row("", rows[row % 3]);
+    settle_row(rows[(row + 1) % 3], rows[(row - 1) % 3], rows[row % 3], totals);
   }
-  std::cout << "PART1: " << part1_ans << "\n";
-  std::cout << "PART2: " << part2_sum << "\n";
+  std::cout << "PART1: " << totals.part1 << std::endl;
+  std::cout << "PART2: " << totals.part2 << std::endl;
   return 0;
 }
+} // namespace day3
+AOC_DAY_COMMAND(3, parse, part1, part2, stream)
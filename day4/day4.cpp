@@ -1,79 +1,200 @@
+#include <algorithm>
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <array>
-#include <optional>
-#include <cmath>
+#include <bit>
 #include <numeric>
 #include <execution>
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "./day.out input.txt is the format required\n";
-    return 1;
-  }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << "file cannot be opened\n";
-    return 1;
-  }
-  char line[512];
-  std::array<std::string_view, 256> winning;
-  int32_t winning_idx = 0;
-  int32_t part1_sum = 0;
-  int32_t num_lines = 0;
-  std::vector<int32_t> card_num_winnings;
-  card_num_winnings.reserve(500);
-  while (input.getline(line, 512)) {
-    ++num_lines;
-    int32_t line_length = input.gcount() - 1;
-    bool past_semi = false;
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+#include "../common/pool.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+namespace day4 {
+// Cards as bitsets of their numbers, so the matches of a card are an AND and
+// a popcount however many numbers it has. Every number in the puzzle is
+// below 100; bits is a template parameter so bigger numbers only need a
+// wider deck.
+template <size_t bits>
+struct Deck {
+  static constexpr size_t words = (bits + 63) / 64;
+  // word-major, winning[word][card], so neighbouring cards are next to each
+  // other for the batched path
+  std::array<std::vector<uint64_t>, words> winning;
+  std::array<std::vector<uint64_t>, words> holding;
+  size_t size() const { return winning[0].size(); }
+};
+using Cards = Deck<128>;
+
+template <size_t bits>
+void parse_cards(std::string_view text, Deck<bits> &deck) {
+  for (std::string_view line : Lines{text}) {
+    size_t idx = line.find(':');
+    if (idx == std::string_view::npos) {
+      continue;
+    }
+    std::array<uint64_t, Deck<bits>::words> winning{};
+    std::array<uint64_t, Deck<bits>::words> holding{};
     bool past_pipe = false;
-    std::optional<int32_t> start_of_number;
-    int32_t matches = 0;
-    for (int32_t idx = 0; idx < line_length; ++idx) {
-      if (line[idx] == ':') {
-        past_semi = true;
-      } else if (line[idx] == '|') {
+    while (idx < line.length()) {
+      if (line[idx] == '|') {
         past_pipe = true;
       }
-      if (past_semi) {
-        if (line[idx] >= '0' && line[idx] <= '9' && !start_of_number.has_value()) {
-          start_of_number = idx;
-        }
-        if (start_of_number.has_value() && (line[idx] == ' ' || idx == line_length - 1)) {
-          if (!past_pipe) {
-            winning[winning_idx] = std::string_view(line + *start_of_number, idx - *start_of_number);
-            ++winning_idx;
-          } else {
-            std::string_view holding_number(
-                line + *start_of_number,
-                (idx == line_length - 1 ? line_length : idx) - *start_of_number
-            );
-            for (int32_t curr_winning = 0; curr_winning < winning_idx; ++curr_winning) {
-              if (holding_number == winning[curr_winning]) {
-                ++matches;
-                break;
-              }
-            }
-          }
-          start_of_number.reset();
-        }
+      if (!is_digit(line[idx])) {
+        ++idx;
+        continue;
       }
+      uint64_t number = parse_digits(line, idx);
+      if (number >= bits) {
+        throw std::out_of_range("card number " + std::to_string(number) + " does not fit the deck");
+      }
+      (past_pipe ? holding : winning)[number / 64] |= 1ull << (number % 64);
+    }
+    for (size_t word = 0; word < Deck<bits>::words; ++word) {
+      deck.winning[word].push_back(winning[word]);
+      deck.holding[word].push_back(holding[word]);
+    }
+  }
+}
+// every newline aligned chunk of the input is parsed on the pool, then the
+// decks are copied one after the other
+template <size_t bits>
+Deck<bits> parse_deck(std::string_view input) {
+  std::vector<std::string_view> text = line_chunks(input, 1 << 20);
+  std::vector<Deck<bits>> chunks(text.size());
+  parallel_for(text.size(), [&](size_t idx) { parse_cards(text[idx], chunks[idx]); });
+  std::vector<size_t> offsets(chunks.size() + 1, 0);
+  for (size_t idx = 0; idx < chunks.size(); ++idx) {
+    offsets[idx + 1] = offsets[idx] + chunks[idx].size();
+  }
+  Deck<bits> deck;
+  for (size_t word = 0; word < Deck<bits>::words; ++word) {
+    deck.winning[word].resize(offsets.back());
+    deck.holding[word].resize(offsets.back());
+  }
+  parallel_for(chunks.size(), [&](size_t idx) {
+    for (size_t word = 0; word < Deck<bits>::words; ++word) {
+      std::copy(chunks[idx].winning[word].begin(), chunks[idx].winning[word].end(),
+                deck.winning[word].begin() + (ptrdiff_t)offsets[idx]);
+      std::copy(chunks[idx].holding[word].begin(), chunks[idx].holding[word].end(),
+                deck.holding[word].begin() + (ptrdiff_t)offsets[idx]);
     }
-    card_num_winnings.push_back(matches);
-    if (matches > 0) {
-      part1_sum += 1 << (matches - 1);
+  });
+  return deck;
+}
+Cards parse(std::string_view input) { return parse_deck<128>(input); }
+
+template <size_t bits>
+void count_matches_scalar(const Deck<bits> &deck, size_t begin, size_t end,
+                          std::vector<int32_t> &matches) {
+  for (size_t card = begin; card < end; ++card) {
+    int32_t count = 0;
+    for (size_t word = 0; word < Deck<bits>::words; ++word) {
+      count += std::popcount(deck.winning[word][card] & deck.holding[word][card]);
     }
-    winning_idx = 0;
+    matches[card] = count;
   }
-  std::vector<int32_t> count_of_each_card(num_lines, 1);
+}
+#if defined(__x86_64__)
+// Four cards at a time: popcount of every byte through a nibble lookup,
+// then the bytes of each 64 bit lane summed with sad. Returns the first card
+// it did not do; the scalar loop finishes the rest.
+template <size_t bits>
+__attribute__((target("avx2"))) size_t count_matches_avx2(const Deck<bits> &deck, size_t begin,
+                                                          size_t end,
+                                                          std::vector<int32_t> &matches) {
+  // a byte counts at most 8 bits per word
+  static_assert(Deck<bits>::words * 8 < 256);
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+  size_t card = begin;
+  for (; card + 4 <= end; card += 4) {
+    __m256i byte_counts = _mm256_setzero_si256();
+    for (size_t word = 0; word < Deck<bits>::words; ++word) {
+      __m256i both = _mm256_and_si256(
+          _mm256_loadu_si256((const __m256i *)(deck.winning[word].data() + card)),
+          _mm256_loadu_si256((const __m256i *)(deck.holding[word].data() + card)));
+      __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(both, low_nibbles));
+      __m256i high =
+          _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(both, 4), low_nibbles));
+      byte_counts = _mm256_add_epi8(byte_counts, _mm256_add_epi8(low, high));
+    }
+    alignas(32) uint64_t counts[4];
+    _mm256_store_si256((__m256i *)counts, _mm256_sad_epu8(byte_counts, _mm256_setzero_si256()));
+    for (size_t lane = 0; lane < 4; ++lane) {
+      matches[card + lane] = (int32_t)counts[lane];
+    }
+  }
+  return card;
+}
+#endif
+// a parallel map over blocks of cards
+template <size_t bits>
+std::vector<int32_t> count_matches(const Deck<bits> &deck) {
+  constexpr size_t block = 1 << 16;
+  std::vector<int32_t> matches(deck.size(), 0);
+  parallel_for((deck.size() + block - 1) / block, [&](size_t idx) {
+    size_t begin = idx * block;
+    size_t end = std::min(deck.size(), begin + block);
+#if defined(__x86_64__)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+      begin = count_matches_avx2(deck, begin, end, matches);
+    }
+#endif
+    count_matches_scalar(deck, begin, end, matches);
+  });
+  return matches;
+}
+// A card scores 2^(matches - 1). With a deck of 128 numbers that can pass
+// int64_t, so such cards and sums are reported instead of wrapping.
+int64_t part1(const Cards &cards) {
+  constexpr int64_t limit = std::numeric_limits<int64_t>::max();
+  std::vector<int32_t> card_matches = count_matches(cards);
+  int64_t part1_sum = 0;
+  for (size_t idx = 0; idx < card_matches.size(); ++idx) {
+    int32_t matches = card_matches[idx];
+    if (matches == 0) {
+      continue;
+    }
+    if (matches > 63) {
+      throw std::overflow_error("card " + std::to_string(idx + 1) + " has " +
+                                std::to_string(matches) + " matches, past int64_t points");
+    }
+    int64_t points = int64_t{1} << (matches - 1);
+    if (part1_sum > limit - points) {
+      throw std::overflow_error("the cards are worth more than int64_t points");
+    }
+    part1_sum += points;
+  }
+  return part1_sum;
+}
+int64_t part2(const Cards &cards) {
+  int32_t num_lines = (int32_t)cards.size();
+  std::vector<int32_t> card_num_winnings = count_matches(cards);
+  // every copy of a card wins one copy of each of the next matches cards, so
+  // card idx adds its count to a range; the range is recorded as +count at
+  // its start and -count past its end, and a running sum of those gives the
+  // copies of every card in one pass
+  std::vector<int64_t> count_of_each_card(num_lines, 1);
+  std::vector<int64_t> difference(num_lines + 1, 0);
+  int64_t won = 0;
   for (int32_t idx_of_card = 0; idx_of_card < num_lines; ++idx_of_card) {
-    for (int32_t idx_of_increment = idx_of_card + 1;
-        idx_of_increment < idx_of_card + card_num_winnings[idx_of_card] + 1;
-        ++idx_of_increment) {
-      count_of_each_card[idx_of_increment] += 1 * count_of_each_card[idx_of_card];
+    won += difference[idx_of_card];
+    count_of_each_card[idx_of_card] += won;
+    int32_t last = std::min(num_lines, idx_of_card + card_num_winnings[idx_of_card] + 1);
+    if (last > idx_of_card + 1) {
+      difference[idx_of_card + 1] += count_of_each_card[idx_of_card];
+      difference[last] -= count_of_each_card[idx_of_card];
     }
   }
-  std::cout << "PART1: " << part1_sum << std::endl;
-  std::cout << "PART2: " << std::reduce(std::execution::par, count_of_each_card.begin(), count_of_each_card.end()) << std::endl;
+  return std::reduce(std::execution::par, count_of_each_card.begin(), count_of_each_card.end());
 }
+} // namespace day4
+AOC_DAY(4, parse, part1, part2)
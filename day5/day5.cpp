@@ -2,97 +2,179 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
 #include <tuple>
 #include <optional>
-#include <cmath>
 #include <cstdint>
 #include <algorithm>
+#include <limits>
+#include <numeric>
+#include <functional>
+#include <queue>
 #include <utility>
-int64_t parse_number(std::string_view s) {
-  int32_t length = s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * std::pow(10, length - idx - 1);
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+#include "../common/pool.h"
+namespace day5 {
+// x in [start, end) goes to x + offset
+struct Segment {
+  int64_t start;
+  int64_t end;
+  int64_t offset;
+};
+// A whole map as sorted segments that tile every int64_t, so lookups never
+// fall into a gap. Numbers no rule covers map to themselves, and where rules
+// overlap the first one listed wins, as it would when scanning them in order.
+std::vector<Segment> map_segments(const std::vector<std::tuple<int64_t, int64_t, int64_t>> &rules) {
+  // (position, rule index) where a rule starts or ends, sorted by position
+  std::vector<std::pair<int64_t, int32_t>> starts;
+  std::vector<std::pair<int64_t, int32_t>> ends;
+  for (int32_t idx = 0; idx < (int32_t)rules.size(); ++idx) {
+    auto [dest, src, range] = rules[idx];
+    if (range > 0) {
+      starts.push_back({src, idx});
+      ends.push_back({src + range, idx});
+    }
   }
-  return value;
-}
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int32_t length) {
-  std::vector<int64_t> numbers;
-  std::vector<std::string_view> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int32_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9' && !digit_start.has_value()) {
-      digit_start = num_parser_idx;
+  std::sort(starts.begin(), starts.end());
+  std::sort(ends.begin(), ends.end());
+  std::vector<Segment> segments;
+  segments.reserve(2 * starts.size() + 1);
+  // rules covering the current position, lowest index on top; a rule that
+  // has ended is only dropped once it reaches the top
+  std::priority_queue<int32_t, std::vector<int32_t>, std::greater<int32_t>> active;
+  std::vector<bool> ended(rules.size(), false);
+  int64_t position = std::numeric_limits<int64_t>::min();
+  size_t next_start = 0;
+  size_t next_end = 0;
+  while (position != std::numeric_limits<int64_t>::max()) {
+    while (next_end < ends.size() && ends[next_end].first == position) {
+      ended[ends[next_end++].second] = true;
     }
-    if ((line[num_parser_idx] == ' ' && digit_start.has_value()) || num_parser_idx == length - 1) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      num_strings.push_back(std::string_view(line + *digit_start, num_parser_idx - *digit_start));
-      digit_start.reset();
+    while (next_start < starts.size() && starts[next_start].first == position) {
+      active.push(starts[next_start++].second);
     }
+    while (!active.empty() && ended[active.top()]) {
+      active.pop();
+    }
+    int64_t next = std::numeric_limits<int64_t>::max();
+    if (next_start < starts.size()) {
+      next = std::min(next, starts[next_start].first);
+    }
+    if (next_end < ends.size()) {
+      next = std::min(next, ends[next_end].first);
+    }
+    int64_t offset = 0;
+    if (!active.empty()) {
+      const auto &rule = rules[active.top()];
+      offset = std::get<0>(rule) - std::get<1>(rule);
+    }
+    if (!segments.empty() && segments.back().offset == offset) {
+      segments.back().end = next;
+    } else {
+      segments.push_back(Segment{position, next, offset});
+    }
+    position = next;
   }
-  for (std::string_view &seed_str : num_strings) {
-    numbers.push_back(parse_number(seed_str));
-  }
-  return numbers;
+  return segments;
 }
-std::vector<std::pair<int64_t, int64_t>> change_range_and_add_new_range(
-    const std::vector<std::tuple<int64_t, int64_t, int64_t>> &map,
-    std::vector<std::pair<int64_t, int64_t>> &ranges
-    ) {
-  std::vector<std::pair<int64_t, int64_t>> add_to_ranges;
-  for (const auto &t : map) {
-    int64_t dest = std::get<0>(t);
-    int64_t src = std::get<1>(t);
-    int64_t map_range = std::get<2>(t);
-    for (int32_t idx_ranges = 0; idx_ranges < (int32_t)ranges.size();) {
-      auto p = ranges[idx_ranges];
-      int64_t range_start = p.first;
-      int64_t len_of_range = p.second;
-      // check if there's any overlap
-      if (src < range_start + len_of_range && range_start < src + map_range) {
-        int64_t overlap_start = std::max(src, range_start);
-        int64_t overlap_range = std::min(src + map_range, range_start + len_of_range) - overlap_start;
-        // mapping the start value from src to dest
-        int64_t overlap_start_mapped = overlap_start + (dest - src);
-        add_to_ranges.push_back({overlap_start_mapped, overlap_range});
-        ranges.erase(ranges.begin() + idx_ranges);
-        // if there's any unmapped values from the left
-        if (overlap_start > range_start) {
-          ranges.push_back({range_start, overlap_start - range_start});
-        }
-        // if there's any unmapped values from the right
-        if (range_start + len_of_range > overlap_start + overlap_range) {
-          ranges.push_back({overlap_start + overlap_range,
-          (range_start + len_of_range) - (overlap_start + overlap_range)});
-        }
-        continue;
-      }
-      idx_ranges += 1;
+// the numbers in [start, end)
+struct Range {
+  int64_t start;
+  int64_t end;
+};
+// Sorts ranges by start and merges the ones that overlap or touch.
+void coalesce(std::vector<Range> &ranges) {
+  std::sort(ranges.begin(), ranges.end(),
+            [](const Range &a, const Range &b) { return a.start < b.start; });
+  size_t kept = 0;
+  for (const Range &r : ranges) {
+    if (kept > 0 && r.start <= ranges[kept - 1].end) {
+      ranges[kept - 1].end = std::max(ranges[kept - 1].end, r.end);
+    } else {
+      ranges[kept++] = r;
     }
   }
-  add_to_ranges.insert(add_to_ranges.end(), ranges.begin(), ranges.end());
-  return add_to_ranges;
+  ranges.resize(kept);
 }
-std::ostream& operator<<(std::ostream &os, std::vector<std::pair<int64_t, int64_t>> p) {
-  for (auto pp : p) {
-    os << pp.first << " " << pp.second << std::endl;
+// Cuts ranges, sorted by start, at every boundary of map in one merge pass:
+// the segment that holds the start of a range only moves forward, so each
+// range is found without a search. emit(range index, start, end, segment)
+// gets every piece.
+template <typename F>
+void sweep_ranges(const std::vector<Range> &ranges, const std::vector<Segment> &map, F &&emit) {
+  size_t first = 0;
+  for (size_t idx = 0; idx < ranges.size(); ++idx) {
+    const Range &r = ranges[idx];
+    while (map[first].end <= r.start) {
+      ++first;
+    }
+    for (size_t s = first; s < map.size() && map[s].start < r.end; ++s) {
+      emit(idx, std::max(r.start, map[s].start), std::min(r.end, map[s].end), map[s]);
+    }
   }
-  return os;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
+// second(first(x)) as segments over first's domain. The images of first's
+// segments are sorted once and cut by a single sweep over second into a
+// buffer sized up front. Each image's pieces come out next to each other, so
+// they are put back in domain order by copying runs rather than sorting, and
+// neighbours of equal offset are merged on the way, which keeps the segment
+// count near the number of real boundaries from one map to the next.
+std::vector<Segment> compose(const std::vector<Segment> &first, const std::vector<Segment> &second) {
+  std::vector<std::pair<Range, size_t>> sorted(first.size());
+  for (size_t idx = 0; idx < first.size(); ++idx) {
+    sorted[idx] = {Range{first[idx].start + first[idx].offset, first[idx].end + first[idx].offset},
+                   idx};
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto &a, const auto &b) { return a.first.start < b.first.start; });
+  std::vector<Range> images(first.size());
+  // run_of[segment of first] = index of its image in sorted order
+  std::vector<size_t> run_of(first.size());
+  for (size_t idx = 0; idx < sorted.size(); ++idx) {
+    images[idx] = sorted[idx].first;
+    run_of[sorted[idx].second] = idx;
   }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
+  std::vector<Segment> pieces;
+  pieces.reserve(first.size() + second.size());
+  std::vector<size_t> run_start(first.size() + 1, 0);
+  sweep_ranges(images, second, [&](size_t idx, int64_t start, int64_t end, const Segment &g) {
+    const Segment &f = first[sorted[idx].second];
+    pieces.push_back(Segment{start - f.offset, end - f.offset, f.offset + g.offset});
+    ++run_start[idx + 1];
+  });
+  std::partial_sum(run_start.begin(), run_start.end(), run_start.begin());
+  std::vector<Segment> composed;
+  composed.reserve(pieces.size());
+  for (size_t idx = 0; idx < first.size(); ++idx) {
+    size_t run = run_of[idx];
+    for (size_t piece = run_start[run]; piece < run_start[run + 1]; ++piece) {
+      if (!composed.empty() && composed.back().offset == pieces[piece].offset) {
+        composed.back().end = pieces[piece].end;
+      } else {
+        composed.push_back(pieces[piece]);
+      }
+    }
   }
-  const int32_t LINE_CAPACITY = 512;
-  char line[LINE_CAPACITY];
+  return composed;
+}
+struct Almanac {
+  std::vector<int64_t> seeds;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> seed_to_soil;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> soil_to_fert;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> fert_to_water;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> water_to_light;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> light_to_temp;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> temp_to_humid;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> humid_to_location;
+  // all seven maps composed into one
+  std::vector<Segment> seed_to_location;
+  // the same map as plain arrays for point lookups, segment starts and their
+  // offsets
+  std::vector<int64_t> breakpoints;
+  std::vector<int64_t> offsets;
+};
+Almanac parse(std::string_view input) {
   enum class MapType {
     SeedSoil,
     SoilFert,
@@ -103,24 +185,17 @@ int32_t main(int32_t argc, char *argv[]) {
     HumidLocation,
   };
   std::optional<enum MapType> current_map;
-  std::vector<int64_t> seeds;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> seed_to_soil;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> soil_to_fert;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> fert_to_water;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> water_to_light;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> light_to_temp;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> temp_to_humid;
-  std::vector<std::tuple<int64_t, int64_t, int64_t>> humid_to_location;
-  while (input.getline(line, LINE_CAPACITY)) {
-    int32_t line_length = input.gcount() - 1;
+  Almanac almanac;
+  for (std::string_view line : Lines{input}) {
+    int32_t line_length = (int32_t)line.length();
     if (line_length == 0)
       continue;
     bool has_colon = false;
     for (int32_t idx = 0; idx < line_length; ++idx) {
       if (line[idx] == ':') {
-        std::string_view string_before_colon(line, idx);
+        std::string_view string_before_colon = line.substr(0, idx);
         if (string_before_colon == "seeds") {
-          seeds = parse_string_to_vec_numbers(line + idx + 2, line_length - (idx + 2));
+          almanac.seeds = parse_string_to_vec_numbers(line.substr(idx + 2));
         } else if (string_before_colon == "seed-to-soil map") {
           current_map = MapType::SeedSoil;
         } else if (string_before_colon == "soil-to-fertilizer map") {
@@ -142,7 +217,11 @@ int32_t main(int32_t argc, char *argv[]) {
     }
     if (has_colon)
       continue;
-    std::vector<int64_t> mapping_numbers = parse_string_to_vec_numbers(line, line_length);
+    // a map line is exactly destination, source and length; anything short
+    // of that is skipped rather than read as a range
+    std::array<int64_t, 3> mapping_numbers{};
+    if (parse_numbers(line, mapping_numbers) != 3)
+      continue;
     std::tuple<int64_t, int64_t, int64_t> t = {
       mapping_numbers[0],
       mapping_numbers[1],
@@ -151,116 +230,100 @@ int32_t main(int32_t argc, char *argv[]) {
     if (current_map.has_value()) {
       switch (*current_map) {
         case MapType::SeedSoil:
-        seed_to_soil.push_back(t);
+        almanac.seed_to_soil.push_back(t);
         break;
         case MapType::SoilFert:
-        soil_to_fert.push_back(t);
+        almanac.soil_to_fert.push_back(t);
         break;
         case MapType::FertWater:
-        fert_to_water.push_back(t);
+        almanac.fert_to_water.push_back(t);
         break;
         case MapType::WaterLight:
-        water_to_light.push_back(t);
+        almanac.water_to_light.push_back(t);
         break;
         case MapType::LightTemp:
-        light_to_temp.push_back(t);
+        almanac.light_to_temp.push_back(t);
         break;
         case MapType::TempHumid:
-        temp_to_humid.push_back(t);
+        almanac.temp_to_humid.push_back(t);
         break;
         case MapType::HumidLocation:
-        humid_to_location.push_back(t);
+        almanac.humid_to_location.push_back(t);
         break;
       }
     }
   }
-  input.close();
-  int64_t min_location_1 = ((uint64_t)1 << 63) - 1;
-  for (int64_t seed_num : seeds) {
-    for (std::tuple<int64_t, int64_t, int64_t> &t : seed_to_soil) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
-    }
-    for (std::tuple<int64_t, int64_t, int64_t> &t : soil_to_fert) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
-    }
-    for (std::tuple<int64_t, int64_t, int64_t> &t : fert_to_water) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
-    }
-    for (std::tuple<int64_t, int64_t, int64_t> &t : water_to_light) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
-    }
-    for (std::tuple<int64_t, int64_t, int64_t> &t : light_to_temp) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
+  almanac.seed_to_location = map_segments(almanac.seed_to_soil);
+  for (const auto *rules : {&almanac.soil_to_fert, &almanac.fert_to_water,
+                            &almanac.water_to_light, &almanac.light_to_temp,
+                            &almanac.temp_to_humid, &almanac.humid_to_location}) {
+    almanac.seed_to_location = compose(almanac.seed_to_location, map_segments(*rules));
+  }
+  for (const Segment &segment : almanac.seed_to_location) {
+    almanac.breakpoints.push_back(segment.start);
+    almanac.offsets.push_back(segment.offset);
+  }
+  return almanac;
+}
+// Locations of lanes seeds at once. Each does a branch free binary search
+// for the last breakpoint at or below it; the search always takes the same
+// number of steps, so the lanes advance together and their loads overlap
+// instead of waiting on one another. The first breakpoint is int64_t min,
+// so every seed has one.
+template <size_t lanes>
+void locate_batch(const Almanac &almanac, const int64_t *seeds, int64_t *locations) {
+  const int64_t *breakpoints = almanac.breakpoints.data();
+  size_t base[lanes] = {};
+  size_t count = almanac.breakpoints.size();
+  while (count > 1) {
+    size_t half = count / 2;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+      base[lane] = breakpoints[base[lane] + half] <= seeds[lane] ? base[lane] + half : base[lane];
     }
-    for (std::tuple<int64_t, int64_t, int64_t> &t : temp_to_humid) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
+    count -= half;
+  }
+  for (size_t lane = 0; lane < lanes; ++lane) {
+    locations[lane] = seeds[lane] + almanac.offsets[base[lane]];
+  }
+}
+// locations[idx] = location of seeds[idx], blocks of seeds spread over the pool
+void locate(const Almanac &almanac, const std::vector<int64_t> &seeds,
+            std::vector<int64_t> &locations) {
+  constexpr size_t lanes = 8;
+  constexpr size_t block = 1 << 14;
+  locations.resize(seeds.size());
+  parallel_for((seeds.size() + block - 1) / block, [&](size_t idx) {
+    size_t seed = idx * block;
+    size_t end = std::min(seeds.size(), seed + block);
+    for (; seed + lanes <= end; seed += lanes) {
+      locate_batch<lanes>(almanac, seeds.data() + seed, locations.data() + seed);
     }
-    for (std::tuple<int64_t, int64_t, int64_t> &t : humid_to_location) {
-      int64_t src = std::get<1>(t);
-      int64_t dest = std::get<0>(t);
-      int64_t range = std::get<2>(t);
-      if (seed_num >= src && seed_num <= src + range - 1) {
-        seed_num += dest - src;
-        break;
-      }
+    for (; seed < end; ++seed) {
+      locate_batch<1>(almanac, seeds.data() + seed, locations.data() + seed);
     }
-    min_location_1 = std::min<int64_t>(min_location_1, seed_num);
-  }
-  std::cout << "PART1: " << min_location_1 << std::endl;
-
+  });
+}
+int64_t part1(const Almanac &almanac) {
+  std::vector<int64_t> locations;
+  locate(almanac, almanac.seeds, locations);
+  return std::reduce(locations.begin(), locations.end(), std::numeric_limits<int64_t>::max(),
+                     [](int64_t a, int64_t b) { return std::min(a, b); });
+}
+int64_t part2(const Almanac &almanac) {
   int64_t part2_min_location = ((uint64_t)1 << 63) - 1;
-  for (int32_t idx_seed = 0; idx_seed < (int32_t)seeds.size(); idx_seed += 2) {
-    int64_t seed_start = seeds[idx_seed];
-    int64_t seed_range = seeds[idx_seed + 1];
-    std::vector<std::pair<int64_t, int64_t>> ranges;
-    ranges.push_back({seed_start, seed_range});
-    ranges = change_range_and_add_new_range(seed_to_soil, ranges);
-    ranges = change_range_and_add_new_range(soil_to_fert, ranges);
-    ranges = change_range_and_add_new_range(fert_to_water, ranges);
-    ranges = change_range_and_add_new_range(water_to_light, ranges);
-    ranges = change_range_and_add_new_range(light_to_temp, ranges);
-    ranges = change_range_and_add_new_range(temp_to_humid, ranges);
-    ranges = change_range_and_add_new_range(humid_to_location, ranges);
-    for (const auto &r : ranges) {
-      part2_min_location = std::min<int64_t>(r.first, part2_min_location);
-    }
+  std::vector<Range> seed_ranges;
+  for (int32_t idx_seed = 0; idx_seed + 1 < (int32_t)almanac.seeds.size(); idx_seed += 2) {
+    int64_t seed_start = almanac.seeds[idx_seed];
+    seed_ranges.push_back(Range{seed_start, seed_start + almanac.seeds[idx_seed + 1]});
   }
-  std::cout << "PART2: " << part2_min_location << std::endl;
-  return 0;
+  coalesce(seed_ranges);
+  // every segment is increasing, so the lowest location of each piece of a
+  // seed range is where the piece starts
+  sweep_ranges(seed_ranges, almanac.seed_to_location,
+               [&](size_t, int64_t start, int64_t, const Segment &s) {
+                 part2_min_location = std::min<int64_t>(part2_min_location, start + s.offset);
+               });
+  return part2_min_location;
 }
+} // namespace day5
+AOC_DAY(5, parse, part1, part2)
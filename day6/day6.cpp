@@ -1,106 +1,356 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <array>
-#include <fstream>
-#include <tuple>
-#include <optional>
+#include <bit>
 #include <cmath>
 #include <cstdint>
+#include <random>
 #include <algorithm>
 #include <utility>
-int64_t parse_number(std::string_view s) {
-  int32_t length = s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * std::pow(10, length - idx - 1);
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day6 {
+__extension__ typedef unsigned __int128 u128;
+struct Races {
+  std::vector<int64_t> times;
+  std::vector<int64_t> distances;
+  // every digit of each line run together, for the one long race of part 2
+  std::string big_time;
+  std::string big_distance;
+};
+Races parse(std::string_view input) {
+  Lines lines{input};
+  Lines::Iterator line_it = lines.begin();
+  Races races;
+  auto parse_line = [](std::string_view line, std::vector<int64_t> &numbers, std::string &digits) {
+    size_t colon = line.find(':');
+    line.remove_prefix(colon == std::string_view::npos ? 0 : colon + 1);
+    numbers = parse_string_to_vec_numbers(line);
+    for (char c : line) {
+      if (is_digit(c) && !(digits.empty() && c == '0')) {
+        digits += c;
+      }
+    }
+  };
+  if (line_it != lines.end()) {
+    parse_line(*line_it++, races.times, races.big_time);
   }
-  return value;
+  if (line_it != lines.end()) {
+    parse_line(*line_it++, races.distances, races.big_distance);
+  }
+  return races;
 }
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int32_t length) {
-  std::vector<int64_t> numbers;
-  std::vector<std::string_view> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int32_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9' && !digit_start.has_value()) {
-      digit_start = num_parser_idx;
+
+// Just enough unsigned bignum for races too long for u128: base 2^32 limbs,
+// least significant first, no leading zero limbs.
+struct BigUnsigned {
+  std::vector<uint32_t> limbs;
+  BigUnsigned() = default;
+  BigUnsigned(uint64_t value) {
+    for (; value != 0; value >>= 32) {
+      limbs.push_back((uint32_t)value);
+    }
+  }
+  void trim() {
+    while (!limbs.empty() && limbs.back() == 0) {
+      limbs.pop_back();
+    }
+  }
+  size_t bit_length() const {
+    return limbs.empty() ? 0 : limbs.size() * 32 - (size_t)std::countl_zero(limbs.back());
+  }
+  // multiplies by factor and adds addend, both below 2^32
+  void multiply_add(uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (uint32_t &limb : limbs) {
+      carry += (uint64_t)limb * factor;
+      limb = (uint32_t)carry;
+      carry >>= 32;
+    }
+    if (carry != 0) {
+      limbs.push_back((uint32_t)carry);
+    }
+  }
+  // divides by divisor below 2^32 and returns the remainder
+  uint32_t divide(uint32_t divisor) {
+    uint64_t remainder = 0;
+    for (size_t idx = limbs.size(); idx-- > 0;) {
+      uint64_t current = (remainder << 32) | limbs[idx];
+      limbs[idx] = (uint32_t)(current / divisor);
+      remainder = current % divisor;
+    }
+    trim();
+    return (uint32_t)remainder;
+  }
+  static BigUnsigned from_decimal(std::string_view digits) {
+    BigUnsigned value;
+    for (char c : digits) {
+      value.multiply_add(10, (uint32_t)(c - '0'));
     }
-    if ((line[num_parser_idx] == ' ' && digit_start.has_value()) || num_parser_idx == length - 1) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      num_strings.push_back(std::string_view(line + *digit_start, num_parser_idx - *digit_start));
-      digit_start.reset();
+    return value;
+  }
+  std::string to_decimal() const {
+    if (limbs.empty()) {
+      return "0";
+    }
+    BigUnsigned rest = *this;
+    std::string digits;
+    while (!rest.limbs.empty()) {
+      digits += (char)('0' + rest.divide(10));
     }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
   }
-  for (std::string_view &seed_str : num_strings) {
-    numbers.push_back(parse_number(seed_str));
+};
+bool operator<(const BigUnsigned &a, const BigUnsigned &b) {
+  if (a.limbs.size() != b.limbs.size()) {
+    return a.limbs.size() < b.limbs.size();
   }
-  return numbers;
+  return std::lexicographical_compare(a.limbs.rbegin(), a.limbs.rend(), b.limbs.rbegin(),
+                                      b.limbs.rend());
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
+bool operator<=(const BigUnsigned &a, const BigUnsigned &b) { return !(b < a); }
+bool operator>(const BigUnsigned &a, const BigUnsigned &b) { return b < a; }
+BigUnsigned operator+(const BigUnsigned &a, const BigUnsigned &b) {
+  BigUnsigned sum;
+  uint64_t carry = 0;
+  for (size_t idx = 0; idx < std::max(a.limbs.size(), b.limbs.size()) || carry != 0; ++idx) {
+    carry += idx < a.limbs.size() ? a.limbs[idx] : 0;
+    carry += idx < b.limbs.size() ? b.limbs[idx] : 0;
+    sum.limbs.push_back((uint32_t)carry);
+    carry >>= 32;
   }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
+  return sum;
+}
+// a - b, for a >= b
+BigUnsigned operator-(const BigUnsigned &a, const BigUnsigned &b) {
+  BigUnsigned difference = a;
+  int64_t borrow = 0;
+  for (size_t idx = 0; idx < difference.limbs.size(); ++idx) {
+    int64_t current = (int64_t)difference.limbs[idx] - borrow -
+                      (idx < b.limbs.size() ? (int64_t)b.limbs[idx] : 0);
+    borrow = current < 0 ? 1 : 0;
+    difference.limbs[idx] = (uint32_t)(current + (borrow << 32));
   }
-  const int32_t LINE_CAPACITY = 512;
-  char line[LINE_CAPACITY];
-  std::vector<int64_t> times;
-  if (input.getline(line, LINE_CAPACITY)) {
-    int32_t line_length = input.gcount() - 1;
-    int32_t idx_of_digits = 0;
-    for (int32_t idx = 0; idx < line_length; ++idx) {
-      if (line[idx] >= '0' && line[idx] <= '9') {
-        idx_of_digits = idx;
-        break;
-      }
+  difference.trim();
+  return difference;
+}
+BigUnsigned operator*(const BigUnsigned &a, const BigUnsigned &b) {
+  BigUnsigned product;
+  product.limbs.assign(a.limbs.size() + b.limbs.size(), 0);
+  for (size_t i = 0; i < a.limbs.size(); ++i) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < b.limbs.size() || carry != 0; ++j) {
+      carry += product.limbs[i + j] + (j < b.limbs.size() ? (uint64_t)a.limbs[i] * b.limbs[j] : 0);
+      product.limbs[i + j] = (uint32_t)carry;
+      carry >>= 32;
     }
-    times = parse_string_to_vec_numbers(line + idx_of_digits, line_length - idx_of_digits);
   }
-  std::vector<int64_t> distances;
-  if (input.getline(line, LINE_CAPACITY)) {
-    int32_t line_length = input.gcount() - 1;
-    int32_t idx_of_digits = 0;
-    for (int32_t idx = 0; idx < line_length; ++idx) {
-      if (line[idx] >= '0' && line[idx] <= '9') {
-        idx_of_digits = idx;
-        break;
-      }
+  product.trim();
+  return product;
+}
+BigUnsigned operator>>(const BigUnsigned &a, size_t shift) {
+  BigUnsigned shifted;
+  size_t limb_shift = shift / 32;
+  size_t bit_shift = shift % 32;
+  for (size_t idx = limb_shift; idx < a.limbs.size(); ++idx) {
+    uint64_t pair = a.limbs[idx] | (idx + 1 < a.limbs.size() ? (uint64_t)a.limbs[idx + 1] << 32 : 0);
+    shifted.limbs.push_back((uint32_t)(pair >> bit_shift));
+  }
+  shifted.trim();
+  return shifted;
+}
+BigUnsigned operator<<(const BigUnsigned &a, size_t shift) {
+  BigUnsigned shifted;
+  shifted.limbs.assign(shift / 32, 0);
+  uint32_t carry = 0;
+  for (uint32_t limb : a.limbs) {
+    shifted.limbs.push_back(shift % 32 == 0 ? limb : (limb << (shift % 32)) | carry);
+    carry = shift % 32 == 0 ? 0 : limb >> (32 - shift % 32);
+  }
+  if (carry != 0) {
+    shifted.limbs.push_back(carry);
+  }
+  shifted.trim();
+  return shifted;
+}
+
+// floor(sqrt(n)), from a floating point guess fixed up with one Newton step
+// and exact checks
+u128 isqrt(u128 n) {
+  if (n == 0) {
+    return 0;
+  }
+  u128 x = (u128)std::sqrt((long double)n);
+  if (x != 0) {
+    x = (x + n / x) / 2;
+  }
+  while (x * x > n) {
+    --x;
+  }
+  while ((x + 1) * (x + 1) <= n) {
+    ++x;
+  }
+  return x;
+}
+// floor(sqrt(n)) one bit of the root at a time, with shifts and subtractions
+BigUnsigned isqrt(BigUnsigned n) {
+  BigUnsigned root;
+  if (n.limbs.empty()) {
+    return root;
+  }
+  // highest power of 4 at or below n
+  BigUnsigned bit = BigUnsigned(1) << ((n.bit_length() - 1) / 2 * 2);
+  while (!bit.limbs.empty()) {
+    BigUnsigned candidate = root + bit;
+    if (candidate <= n) {
+      n = n - candidate;
+      root = (root >> 1) + bit;
+    } else {
+      root = root >> 1;
     }
-    distances = parse_string_to_vec_numbers(line + idx_of_digits, line_length - idx_of_digits);
-  }
-  input.close();
-  int64_t part1_product = 1;
-  for (int64_t idx_time = 0; idx_time < (int64_t)times.size(); ++idx_time) {
-    int64_t count = 0;
-    for (int64_t time = 1; time <= times[idx_time]; ++time) {
-      if ((times[idx_time] - time) * time > distances[idx_time]) {
-        count += 1;
-      }
+    bit = bit >> 2;
+  }
+  return root;
+}
+// Hold times h in [1, time] with h * (time - h) > distance. The winners are
+// the integers strictly between the roots of h^2 - time * h + distance, so
+// the first one is within a step of (time - isqrt(time^2 - 4 * distance)) / 2
+// and the rest follow by symmetry. Number is u128 or BigUnsigned.
+template <typename Number>
+Number count_wins(const Number &time, const Number &distance) {
+  const Number one(1);
+  Number four_distance = distance + distance + distance + distance;
+  if (time * time <= four_distance) {
+    return Number(0);
+  }
+  Number first = (time - isqrt(time * time - four_distance)) >> 1;
+  while (first + first <= time && first * (time - first) <= distance) {
+    first = first + one;
+  }
+  if (first + first > time) {
+    return Number(0);
+  }
+  while (first > one && (first - one) * (time - first + one) > distance) {
+    first = first - one;
+  }
+  return time - first - first + one;
+}
+
+std::string to_decimal(u128 value) {
+  std::string digits;
+  do {
+    digits += (char)('0' + (int32_t)(value % 10));
+    value /= 10;
+  } while (value != 0);
+  std::reverse(digits.begin(), digits.end());
+  return digits;
+}
+u128 parse_u128(std::string_view digits) {
+  u128 value = 0;
+  for (char c : digits) {
+    value = value * 10 + (u128)(c - '0');
+  }
+  return value;
+}
+// Wins of the one long race as decimal digits. Up to 19 digits of time and
+// 37 of distance, time^2 and 4 * distance fit in u128; past that the race
+// goes through BigUnsigned.
+std::string big_race_wins(const Races &races) {
+  if (races.big_time.length() <= 19 && races.big_distance.length() <= 37) {
+    return to_decimal(count_wins(parse_u128(races.big_time), parse_u128(races.big_distance)));
+  }
+  return count_wins(BigUnsigned::from_decimal(races.big_time),
+                    BigUnsigned::from_decimal(races.big_distance))
+      .to_decimal();
+}
+
+// Product of every race's wins as decimal digits, in u128 until the next
+// factor would overflow it and in BigUnsigned from there.
+std::string race_product(const Races &races) {
+  size_t count = std::min(races.times.size(), races.distances.size());
+  u128 product = 1;
+  size_t idx = 0;
+  for (; idx < count; ++idx) {
+    u128 wins = count_wins((u128)races.times[idx], (u128)races.distances[idx]);
+    if (wins != 0 && product > ~(u128)0 / wins) {
+      break;
     }
-    part1_product *= count;
+    product *= wins;
   }
-  std::cout << "PART1: " << part1_product << std::endl;
-  std::string one_big_time;
-  for (auto n : times) {
-    one_big_time += std::to_string(n);
+  if (idx == count) {
+    return to_decimal(product);
   }
-  std::string one_big_distance;
-  for (auto d : distances) {
-    one_big_distance += std::to_string(d);
+  BigUnsigned big = (BigUnsigned((uint64_t)(product >> 64)) << 64) + BigUnsigned((uint64_t)product);
+  for (; idx < count; ++idx) {
+    // a race's wins never exceed its time, so they fit uint64_t
+    big = big * BigUnsigned((uint64_t)count_wins((u128)races.times[idx], (u128)races.distances[idx]));
   }
-  int64_t one_time = parse_number(std::string_view(one_big_time));
-  int64_t one_distance = parse_number(std::string_view(one_big_distance));
+  return big.to_decimal();
+}
+// digits as the part's answer, through WideAnswer when they do not fit int64_t
+int64_t answer(std::string digits) {
+  if (digits.length() > 19 || (digits.length() == 19 && digits > "9223372036854775807")) {
+    throw WideAnswer(std::move(digits));
+  }
+  return parse_number(digits);
+}
+
+int64_t part1(const Races &races) { return answer(race_product(races)); }
+int64_t part2(const Races &races) { return answer(big_race_wins(races)); }
+
+// brute force count, for --verify
+int64_t count_wins_by_trying(int64_t time, int64_t distance) {
   int64_t count = 0;
-  for (int64_t time = 1; time <= one_time; ++time) {
-    if ((one_time - time) * time > one_distance) {
+  for (int64_t hold = 1; hold <= time; ++hold) {
+    if ((time - hold) * hold > distance) {
       count += 1;
     }
   }
-  std::cout << "PART2: " << count << std::endl;
+  return count;
+}
+// ./day6 input.txt --verify N   checks both closed forms against brute force
+//                               for every time up to N (default 100), and
+//                               against each other on long random races
+int32_t command(const char *, const std::vector<std::string_view> &args) {
+  if (args.empty() || args[0] != "--verify" || args.size() > 2) {
+    std::cerr << "day6 options: --verify [N]\n";
+    return 1;
+  }
+  int64_t limit = args.size() == 2 ? parse_number(args[1]) : 100;
+  int64_t cases = 0;
+  for (int64_t time = 0; time <= limit; ++time) {
+    for (int64_t distance = 0; distance <= time * time / 4 + 1; ++distance) {
+      int64_t expected = count_wins_by_trying(time, distance);
+      u128 wins = count_wins((u128)time, (u128)distance);
+      std::string big_wins = count_wins(BigUnsigned((uint64_t)time), BigUnsigned((uint64_t)distance))
+                                 .to_decimal();
+      if ((int64_t)wins != expected || big_wins != std::to_string(expected)) {
+        std::cerr << "time " << time << " distance " << distance << ": expected " << expected
+                  << ", u128 " << to_decimal(wins) << ", bignum " << big_wins << "\n";
+        return 1;
+      }
+      ++cases;
+    }
+  }
+  // and the two closed forms against each other on races too long to try
+  std::mt19937_64 rng(2023);
+  for (int32_t race = 0; race < 10000; ++race) {
+    uint64_t time = rng() >> (rng() % 40);
+    u128 distance = (u128)time * time / 4 - (u128)(rng() % (time / 2 + 1)) * (rng() % (time / 2 + 1));
+    std::string wins = to_decimal(count_wins((u128)time, distance));
+    std::string big_wins =
+        count_wins(BigUnsigned(time), BigUnsigned::from_decimal(to_decimal(distance))).to_decimal();
+    if (wins != big_wins) {
+      std::cerr << "time " << time << " distance " << to_decimal(distance) << ": u128 " << wins
+                << ", bignum " << big_wins << "\n";
+      return 1;
+    }
+    ++cases;
+  }
+  std::cout << "verified " << cases << " races\n";
   return 0;
 }
+} // namespace day6
+AOC_DAY_COMMAND(6, parse, part1, part2, command)
@@ -2,250 +2,290 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
-#include <tuple>
-#include <optional>
-#include <cmath>
 #include <cstdint>
 #include <algorithm>
+#include <functional>
 #include <utility>
-int64_t parse_number(std::string_view s) {
-  int32_t length = s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * std::pow(10, length - idx - 1);
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+#include "../common/pool.h"
+namespace day7 {
+// weakest first, so a hand type and a card rank compare as plain integers
+enum class HandType {
+  HighCard,
+  OnePair,
+  TwoPair,
+  ThreeKind,
+  FullHouse,
+  FourKind,
+  FiveKind,
+};
+// char -> rank in order (weakest first), 0xff for anything that is not a card
+constexpr std::array<uint8_t, 256> make_card_ranks(std::string_view order) {
+  std::array<uint8_t, 256> ranks{};
+  for (uint8_t &rank : ranks) {
+    rank = 0xff;
+  }
+  for (size_t idx = 0; idx < order.length(); ++idx) {
+    ranks[(uint8_t)order[idx]] = (uint8_t)idx;
   }
-  return value;
+  return ranks;
 }
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int32_t length) {
-  std::vector<int64_t> numbers;
-  std::vector<std::string_view> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int32_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9' && !digit_start.has_value()) {
-      digit_start = num_parser_idx;
+
+// A rule set is a card order (weakest first, at most 16 cards) and an
+// optional wildcard, '\0' for none.
+struct Standard {
+  static constexpr std::string_view order = "23456789TJQKA";
+  static constexpr char wildcard = '\0';
+};
+// J is a joker in part 2 and the weakest card on its own
+struct Jokers {
+  static constexpr std::string_view order = "J23456789TQKA";
+  static constexpr char wildcard = 'J';
+};
+
+// [wildcards][equal pairs among the other cards]; a full house has 3 + 1
+// pairs, four of a kind 6 and five of a kind 10
+constexpr HandType types_by_pairs[6][11] = {
+  {HandType::HighCard, HandType::OnePair, HandType::TwoPair, HandType::ThreeKind,
+   HandType::FullHouse, HandType::HighCard, HandType::FourKind, HandType::HighCard,
+   HandType::HighCard, HandType::HighCard, HandType::FiveKind},
+  {HandType::OnePair, HandType::ThreeKind, HandType::FullHouse, HandType::FourKind,
+   HandType::HighCard, HandType::HighCard, HandType::FiveKind},
+  {HandType::ThreeKind, HandType::FourKind, HandType::HighCard, HandType::FiveKind},
+  {HandType::FourKind, HandType::FiveKind},
+  {HandType::FiveKind},
+  {HandType::FiveKind},
+};
+
+template <typename Rules>
+struct Ranking {
+  static_assert(Rules::order.length() <= 16, "a card rank has to fit in 4 bits");
+  static constexpr std::array<uint8_t, 256> ranks = make_card_ranks(Rules::order);
+
+  // The type only depends on how many pairs of the other cards are equal and
+  // on how many wildcards there are, which join the largest group.
+  static HandType type(const char *hand) {
+    int32_t wildcards = 0;
+    if constexpr (Rules::wildcard != '\0') {
+      for (size_t idx = 0; idx < 5; ++idx) {
+        wildcards += hand[idx] == Rules::wildcard;
+      }
     }
-    if ((line[num_parser_idx] == ' ' && digit_start.has_value()) || num_parser_idx == length - 1) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      num_strings.push_back(std::string_view(line + *digit_start, num_parser_idx - *digit_start));
-      digit_start.reset();
+    int32_t pairs = 0;
+    for (size_t a = 0; a < 5; ++a) {
+      for (size_t b = a + 1; b < 5; ++b) {
+        bool wild = false;
+        if constexpr (Rules::wildcard != '\0') {
+          wild = hand[a] == Rules::wildcard;
+        }
+        pairs += !wild & (hand[a] == hand[b]);
+      }
     }
+    return types_by_pairs[wildcards][pairs];
   }
-  for (std::string_view &seed_str : num_strings) {
-    numbers.push_back(parse_number(seed_str));
+  // The whole ordering of a hand in one integer: the type above the five card
+  // ranks, 4 bits each with the first card highest. 23 bits used.
+  static uint32_t key(const char *hand) {
+    uint32_t key = (uint32_t)type(hand);
+    for (size_t idx = 0; idx < 5; ++idx) {
+      key = (key << 4) | ranks[(uint8_t)hand[idx]];
+    }
+    return key;
   }
-  return numbers;
-}
-constexpr std::array<char, 13> card_ranks = {
-'A',
-'K',
-'Q',
-'J',
-'T',
-'9',
-'8',
-'7',
-'6',
-'5', 
-'4',
-'3',
-'2'
 };
-constexpr std::array<char, 13> card_ranks_part2 = {
-'A',
-'K',
-'Q',
-'T',
-'9',
-'8',
-'7',
-'6',
-'5', 
-'4',
-'3',
-'2',
-'J',
+
+// the five cards inline next to the bid, so the hands are one flat array
+struct Hand {
+  std::array<char, 5> cards;
+  int64_t bid;
 };
-enum class HandType {
-  FiveKind,
-  FourKind,
-  FullHouse,
-  ThreeKind,
-  TwoPair,
-  OnePair,
-  HighCard,
+struct Hands {
+  std::vector<Hand> hands;
+  size_t size() const { return hands.size(); }
 };
-bool compare_hand(HandType a, HandType b) {
-  return a > b;
-}
-HandType get_type(const std::string &hand, bool is_part2) {
-  std::array<int32_t, 13> count = {
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-  };
-  for (char c : hand) {
-    switch (c) {
-      case 'A': count[0]++;break;
-      case 'K': count[1]++;break;
-      case 'Q': count[2]++;break;
-      case 'J': count[3]++;break;
-      case 'T': count[4]++;break;
-      case '9': count[5]++;break;
-      case '8': count[6]++;break;
-      case '7': count[7]++;break;
-      case '6': count[8]++;break;
-      case '5': count[9]++;break; 
-      case '4': count[10]++;break;
-      case '3': count[11]++;break;
-      case '2': count[12]++;break;
+Hands parse(std::string_view input) {
+  std::vector<std::string_view> text = line_chunks(input, 1 << 20);
+  std::vector<std::vector<Hand>> chunks(text.size());
+  parallel_for(text.size(), [&](size_t idx) {
+    for (std::string_view line : Lines{text[idx]}) {
+      if (line.length() < 6 || line[5] != ' ' ||
+          std::any_of(line.begin(), line.begin() + 5,
+                      [](char c) { return Ranking<Standard>::ranks[(uint8_t)c] == 0xff; })) {
+        continue;
+      }
+      Hand &hand = chunks[idx].emplace_back();
+      std::copy(line.begin(), line.begin() + 5, hand.cards.begin());
+      hand.bid = parse_number(line.substr(6));
     }
+  });
+  std::vector<size_t> offsets(chunks.size() + 1, 0);
+  for (size_t idx = 0; idx < chunks.size(); ++idx) {
+    offsets[idx + 1] = offsets[idx] + chunks[idx].size();
   }
-  if (is_part2) {
-    int32_t j_count = count[3];
-    count[3] = 0;
-    int32_t idx_of_max = 0;
-    for (int32_t idx_of_count = 0; idx_of_count < 13; ++idx_of_count) {
-      if (count[idx_of_max] < count[idx_of_count]) {
-        idx_of_max = idx_of_count;
-      }
+  Hands hands;
+  hands.hands.resize(offsets.back());
+  parallel_for(chunks.size(), [&](size_t idx) {
+    std::copy(chunks[idx].begin(), chunks[idx].end(),
+              hands.hands.begin() + (ptrdiff_t)offsets[idx]);
+  });
+  return hands;
+}
+
+// Entries are key << 32 | hand index, so the index rides along, equal hands
+// keep input order and no two entries are equal. Each part builds its own, so
+// --bench times the two rule sets separately.
+template <typename Rules>
+std::vector<uint64_t> make_entries(const Hands &hands) {
+  constexpr size_t block = 1 << 16;
+  std::vector<uint64_t> entries(hands.size());
+  parallel_for((entries.size() + block - 1) / block, [&](size_t b) {
+    for (size_t idx = b * block; idx < std::min(entries.size(), (b + 1) * block); ++idx) {
+      entries[idx] = (uint64_t)Ranking<Rules>::key(hands.hands[idx].cards.data()) << 32 | idx;
+    }
+  });
+  return entries;
+}
+// LSD radix sort of entries by their 23 bit key, 8 bits a pass. Digits every
+// key shares are skipped. scratch holds as many entries as the range.
+void radix_sort(uint64_t *begin, uint64_t *end, uint64_t *scratch) {
+  constexpr int32_t digits = 3;
+  size_t count_entries = (size_t)(end - begin);
+  std::array<std::array<uint32_t, 256>, digits> counts{};
+  for (uint64_t *entry = begin; entry != end; ++entry) {
+    for (int32_t digit = 0; digit < digits; ++digit) {
+      ++counts[digit][(*entry >> (32 + 8 * digit)) & 0xff];
     }
-    count[idx_of_max] += j_count;
   }
-  std::array<int32_t, 5> count_of_counts = {
-    0,
-    0,
-    0,
-    0,
-    0,
-  };;
-  for (int32_t c : count) {
-    count_of_counts[c - 1]++;
+  uint64_t *from = begin;
+  uint64_t *to = scratch;
+  for (int32_t digit = 0; digit < digits; ++digit) {
+    std::array<uint32_t, 256> &count = counts[digit];
+    uint32_t shift = 32 + 8 * (uint32_t)digit;
+    if (count_entries == 0 || count[(*from >> shift) & 0xff] == count_entries) {
+      continue;
+    }
+    uint32_t offset = 0;
+    for (uint32_t &c : count) {
+      offset += std::exchange(c, offset);
+    }
+    for (size_t idx = 0; idx < count_entries; ++idx) {
+      to[count[(from[idx] >> shift) & 0xff]++] = from[idx];
+    }
+    std::swap(from, to);
   }
-  if (count_of_counts[4] == 1) {
-    return HandType::FiveKind;
-  } else if (count_of_counts[3] == 1 && count_of_counts[0] == 1) {
-    return HandType::FourKind;
-  } else if (count_of_counts[2] == 1 && count_of_counts[1] == 1) {
-    return HandType::FullHouse;
-  } else if (count_of_counts[2] == 1 && count_of_counts[0] == 2) {
-    return HandType::ThreeKind;
-  } else if (count_of_counts[1] == 2 && count_of_counts[0] == 1) {
-    return HandType::TwoPair;
-  } else if (count_of_counts[1] == 1 && count_of_counts[0] == 3) {
-    return HandType::OnePair;
+  if (from != begin) {
+    std::copy(from, from + count_entries, begin);
   }
-  return HandType::HighCard;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
+// Sample sort on the pool: splitters picked from an evenly spaced sample cut
+// the entries into one bucket per task, every block of entries is counted and
+// scattered into the buckets in parallel, then each bucket is radix sorted on
+// its own. Small inputs are radix sorted directly.
+void sample_sort(std::vector<uint64_t> &entries) {
+  constexpr size_t block = 1 << 16;
+  std::vector<uint64_t> scratch(entries.size());
+  size_t bucket_count = std::min<size_t>(pool().size() * 4, 256);
+  if (entries.size() < 2 * block || bucket_count < 2) {
+    radix_sort(entries.data(), entries.data() + entries.size(), scratch.data());
+    return;
   }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
+  constexpr size_t oversampling = 32;
+  std::vector<uint64_t> sample(bucket_count * oversampling);
+  for (size_t idx = 0; idx < sample.size(); ++idx) {
+    sample[idx] = entries[idx * entries.size() / sample.size()];
   }
-  const int32_t LINE_CAPACITY = 512;
-  char line[LINE_CAPACITY];
-  std::vector<std::pair<std::string, int64_t>> card_and_bid;
-  while (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
-    for (size_t idx = 0; idx < line_length; ++idx) {
-      if (line[idx] == ' ') {
-        card_and_bid.push_back({
-          std::string(line, idx + 1),
-          parse_number(std::string_view(line + idx + 1, line_length - (idx + 1)))
-        });
-        break;
-      }
-    }
+  std::sort(sample.begin(), sample.end());
+  std::vector<uint64_t> splitters(bucket_count - 1);
+  for (size_t idx = 0; idx < splitters.size(); ++idx) {
+    splitters[idx] = sample[(idx + 1) * oversampling];
   }
-  auto card_and_bid_part2 = card_and_bid;
-  std::sort(card_and_bid.begin(), card_and_bid.end(), [&](const auto &a, const auto &b) {
-    const std::string &a_hand = a.first;
-    HandType a_hand_type = get_type(a_hand, false);
-
-    const std::string &b_hand = b.first;
-    HandType b_hand_type = get_type(b_hand, false);
-
-    if (a_hand_type == b_hand_type) {
-      for (int32_t idx = 0; idx < 5; ++idx) {
-        if (a_hand[idx] != b_hand[idx]) {
-          int32_t a_hand_card_rank = 0;
-          for (int32_t idx_card_ranking = 0; idx_card_ranking < 13; ++idx_card_ranking) {
-            if (card_ranks[idx_card_ranking] == a_hand[idx]) {
-              a_hand_card_rank = idx_card_ranking;
-              break;
-            }
-          }
-          int32_t b_hand_card_rank = 0;
-          for (int32_t idx_card_ranking = 0; idx_card_ranking < 13; ++idx_card_ranking) {
-            if (card_ranks[idx_card_ranking] == b_hand[idx]) {
-              b_hand_card_rank = idx_card_ranking;
-              break;
-            }
-          }
-          return a_hand_card_rank > b_hand_card_rank;
-        }
-      }
+  auto bucket_of = [&](uint64_t entry) {
+    return (size_t)(std::upper_bound(splitters.begin(), splitters.end(), entry) -
+                    splitters.begin());
+  };
+  size_t blocks = (entries.size() + block - 1) / block;
+  // counts[block][bucket], turned into where each block writes each bucket
+  std::vector<size_t> counts(blocks * bucket_count, 0);
+  std::vector<uint8_t> buckets(entries.size());
+  parallel_for(blocks, [&](size_t b) {
+    for (size_t idx = b * block; idx < std::min(entries.size(), (b + 1) * block); ++idx) {
+      buckets[idx] = (uint8_t)bucket_of(entries[idx]);
+      ++counts[b * bucket_count + buckets[idx]];
     }
-
-    return compare_hand(a_hand_type, b_hand_type);
   });
-  int64_t part1_ans = 0;
-  for (size_t idx = 0; idx < card_and_bid.size(); ++idx) {
-    part1_ans += (idx + 1) * card_and_bid[idx].second;
+  std::vector<size_t> bucket_starts(bucket_count + 1, 0);
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+    bucket_starts[bucket] = offset;
+    for (size_t b = 0; b < blocks; ++b) {
+      offset += std::exchange(counts[b * bucket_count + bucket], offset);
+    }
   }
-  std::cout << "PART1: " << part1_ans << "\n";
-
-  std::sort(card_and_bid_part2.begin(), card_and_bid_part2.end(), [&](const auto& a, const auto& b) {
-    const std::string &a_hand = a.first;
-    HandType a_hand_type = get_type(a_hand, true);
-
-    const std::string &b_hand = b.first;
-    HandType b_hand_type = get_type(b_hand, true);
-
-    if (a_hand_type == b_hand_type) {
-      for (int32_t idx = 0; idx < 5; ++idx) {
-        if (a_hand[idx] != b_hand[idx]) {
-          int32_t a_hand_card_rank = 0;
-          for (int32_t idx_card_ranking = 0; idx_card_ranking < 13; ++idx_card_ranking) {
-            if (card_ranks_part2[idx_card_ranking] == a_hand[idx]) {
-              a_hand_card_rank = idx_card_ranking;
-              break;
-            }
-          }
-          int32_t b_hand_card_rank = 0;
-          for (int32_t idx_card_ranking = 0; idx_card_ranking < 13; ++idx_card_ranking) {
-            if (card_ranks_part2[idx_card_ranking] == b_hand[idx]) {
-              b_hand_card_rank = idx_card_ranking;
-              break;
-            }
-          }
-          return a_hand_card_rank > b_hand_card_rank;
-        }
-      }
+  bucket_starts[bucket_count] = offset;
+  parallel_for(blocks, [&](size_t b) {
+    for (size_t idx = b * block; idx < std::min(entries.size(), (b + 1) * block); ++idx) {
+      scratch[counts[b * bucket_count + buckets[idx]]++] = entries[idx];
     }
-
-    return compare_hand(a_hand_type, b_hand_type);
   });
-  int64_t part2_ans = 0;
-  for (size_t idx = 0; idx < card_and_bid_part2.size(); ++idx) {
-    part2_ans += (idx + 1) * card_and_bid_part2[idx].second;
+  parallel_for(bucket_count, [&](size_t bucket) {
+    size_t begin = bucket_starts[bucket];
+    size_t end = bucket_starts[bucket + 1];
+    radix_sort(scratch.data() + begin, scratch.data() + end, entries.data() + begin);
+  });
+  entries.swap(scratch);
+}
+// sum(rank * bid) with the hands in key order
+template <typename Rules>
+int64_t total_winnings(const Hands &hands) {
+  std::vector<uint64_t> entries = make_entries<Rules>(hands);
+  sample_sort(entries);
+  constexpr size_t block = 1 << 16;
+  return parallel_sum((entries.size() + block - 1) / block, [&](size_t b) {
+    int64_t total = 0;
+    for (size_t idx = b * block; idx < std::min(entries.size(), (b + 1) * block); ++idx) {
+      total += (int64_t)(idx + 1) * hands.hands[(uint32_t)entries[idx]].bid;
+    }
+    return total;
+  });
+}
+int64_t part1(const Hands &hands) {
+  return total_winnings<Standard>(hands);
+}
+int64_t part2(const Hands &hands) {
+  return total_winnings<Jokers>(hands);
+}
+// ./day7 input.txt --top K
+// prints the K best hands under both rule sets as "rank cards bid"; only
+// those K are sorted, nth_element splits them off the rest
+int32_t top_hands(const char *path, const std::vector<std::string_view> &args) {
+  if (args.size() != 2 || args[0] != "--top" || args[1].empty() ||
+      !std::all_of(args[1].begin(), args[1].end(), is_digit)) {
+    std::cerr << "day7 options: --top K\n";
+    return 1;
+  }
+  InputFile input(path);
+  if (!input.is_open()) {
+    std::cerr << path << " file cannot be opened\n";
+    return 1;
+  }
+  Hands hands = parse(input.contents());
+  size_t k = std::min((size_t)parse_number(args[1]), hands.size());
+  for (int32_t part = 1; part <= 2; ++part) {
+    std::vector<uint64_t> entries =
+        part == 1 ? make_entries<Standard>(hands) : make_entries<Jokers>(hands);
+    auto best = entries.begin() + (ptrdiff_t)k;
+    std::nth_element(entries.begin(), best, entries.end(), std::greater<uint64_t>());
+    std::sort(entries.begin(), best, std::greater<uint64_t>());
+    std::cout << "part" << part << "\n";
+    for (size_t idx = 0; idx < k; ++idx) {
+      const Hand &hand = hands.hands[(uint32_t)entries[idx]];
+      std::cout << hands.size() - idx << " " << std::string_view(hand.cards.data(), 5) << " "
+                << hand.bid << "\n";
+    }
   }
-  std::cout << "PART2: " << part2_ans << "\n";
   return 0;
 }
+} // namespace day7
+AOC_DAY_COMMAND(7, parse, part1, part2, top_hands)
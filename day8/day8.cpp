@@ -2,125 +2,575 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <fstream>
-#include <tuple>
-#include <optional>
-#include <cmath>
 #include <cstdint>
 #include <algorithm>
 #include <utility>
-#include <map>
-#include <set>
+#include <stdexcept>
+#include <limits>
 #include <numeric>
-int64_t parse_number(std::string_view s) {
-  int32_t length = s.length();
-  int64_t value = 0;
-  for (int32_t idx = 0; idx < length; ++idx) {
-    value += (s[idx] - '0') * std::pow(10, length - idx - 1);
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/parse.h"
+namespace day8 {
+// Node names are three characters from [0-9A-Z], so base 36 maps every name
+// to a slot in a direct table; ids are handed out in order of appearance.
+constexpr size_t name_slots = 36 * 36 * 36;
+// -1 for anything that is not a node name
+int32_t name_slot(std::string_view name) {
+  int32_t slot = 0;
+  for (char c : name) {
+    if (!is_digit(c) && (c < 'A' || c > 'Z')) {
+      return -1;
+    }
+    slot = slot * 36 + (is_digit(c) ? c - '0' : c - 'A' + 10);
   }
-  return value;
+  return slot;
 }
-std::vector<int64_t> parse_string_to_vec_numbers(char *line, int32_t length) {
-  std::vector<int64_t> numbers;
-  std::vector<std::string_view> num_strings;
-  std::optional<int32_t> digit_start;
-  for (int32_t num_parser_idx = 0; num_parser_idx < length; ++num_parser_idx) {
-    if (line[num_parser_idx] >= '0' && line[num_parser_idx] <= '9' && !digit_start.has_value()) {
-      digit_start = num_parser_idx;
+struct Network {
+  // 0 for L and 1 for R, the row of next to read
+  std::vector<uint8_t> turns;
+  // next[turn][id], so a step is two array loads
+  std::array<std::vector<uint16_t>, 2> next;
+  std::vector<std::array<char, 3>> names;
+  size_t size() const { return names.size(); }
+  int32_t find(std::string_view name) const {
+    for (size_t id = 0; id < names.size(); ++id) {
+      if (std::string_view(names[id].data(), 3) == name) {
+        return (int32_t)id;
+      }
     }
-    if ((line[num_parser_idx] == ' ' && digit_start.has_value()) || num_parser_idx == length - 1) {
-      if (num_parser_idx == length - 1)
-        num_parser_idx = length;
-      num_strings.push_back(std::string_view(line + *digit_start, num_parser_idx - *digit_start));
-      digit_start.reset();
+    return -1;
+  }
+};
+Network parse(std::string_view input) {
+  Lines lines{input};
+  Lines::Iterator line_it = lines.begin();
+  Network network;
+  if (line_it != lines.end()) {
+    for (char c : *line_it++) {
+      if (c == 'L' || c == 'R') {
+        network.turns.push_back(c == 'R');
+      }
     }
   }
-  for (std::string_view &seed_str : num_strings) {
-    numbers.push_back(parse_number(seed_str));
+  std::vector<int32_t> ids(name_slots, -1);
+  auto intern = [&](std::string_view name) {
+    int32_t &id = ids[(size_t)name_slot(name)];
+    if (id < 0) {
+      id = (int32_t)network.names.size();
+      network.names.push_back({name[0], name[1], name[2]});
+      // a node that is never defined stays where it is
+      network.next[0].push_back((uint16_t)id);
+      network.next[1].push_back((uint16_t)id);
+    }
+    return (size_t)id;
+  };
+  for (; line_it != lines.end(); ++line_it) {
+    std::string_view line = *line_it;
+    if (line.length() < 15 || name_slot(line.substr(0, 3)) < 0 ||
+        name_slot(line.substr(7, 3)) < 0 || name_slot(line.substr(12, 3)) < 0)
+      continue;
+    size_t node = intern(line.substr(0, 3));
+    uint16_t left = (uint16_t)intern(line.substr(7, 3));
+    uint16_t right = (uint16_t)intern(line.substr(12, 3));
+    network.next[0][node] = left;
+    network.next[1][node] = right;
   }
-  return numbers;
+  return network;
 }
-int32_t main(int32_t argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "called the binary wrong\n";
-    return 1;
+// Prefix tables larger than this many entries are not built; 2^26 of them
+// take 128 MiB.
+constexpr size_t max_prefix_entries = size_t(1) << 26;
+// Jumps over whole passes of the instructions, for walks far longer than the
+// network. A pass always starts at the first instruction, so its end only
+// depends on the node it starts from. Goals are the nodes to look out for.
+struct Jumps {
+  size_t pass_length = 0;
+  std::vector<uint8_t> goals;
+  // every step in (0, pass_length] of the pass from a node that ends on a goal
+  std::vector<std::vector<uint32_t>> hits;
+  // lands[level][node]: where 2^level passes from node end
+  std::vector<std::vector<uint16_t>> lands;
+  // first_goal[level][node]: the first step in (0, 2^level passes] that ends
+  // on a goal, -1 if none does
+  std::vector<std::vector<int64_t>> first_goal;
+  // prefix[row[node] * pass_length + offset]: where the first offset steps of
+  // a pass from node end, for every node a walked pass starts from (row -1
+  // for the rest). Empty unless asked for and within max_prefix_entries.
+  std::vector<int32_t> row;
+  std::vector<uint16_t> prefix;
+
+  // the node steps steps after node: O(log(steps / pass_length)) jumps and
+  // one prefix lookup, or a walk through the rest of the pass without one
+  uint16_t position_after(uint16_t node, int64_t steps, const Network &network) const {
+    uint64_t passes = (uint64_t)steps / pass_length;
+    for (size_t level = 0; passes != 0; ++level, passes >>= 1) {
+      if (passes & 1) {
+        node = lands[level][node];
+      }
+    }
+    size_t offset = (uint64_t)steps % pass_length;
+    if (!prefix.empty() && row[node] >= 0) {
+      return prefix[(size_t)row[node] * pass_length + offset];
+    }
+    for (size_t idx = 0; idx < offset; ++idx) {
+      node = network.next[network.turns[idx]][node];
+    }
+    return node;
   }
-  std::ifstream input(argv[1]);
-  if (!input.is_open()) {
-    std::cerr << argv[1] << " file cannot be opened\n";
-    return 1;
+  // the first step past after, counting from node at step 0, that ends on a
+  // goal; -1 if the walk never reaches one again within int64_t steps
+  int64_t next_goal(uint16_t node, int64_t after, const Network &network) const {
+    constexpr int64_t limit = std::numeric_limits<int64_t>::max();
+    int64_t base = after - after % (int64_t)pass_length;
+    node = position_after(node, base, network);
+    const std::vector<uint32_t> &pass = hits[node];
+    auto hit = std::upper_bound(pass.begin(), pass.end(), (uint32_t)(after - base));
+    if (hit != pass.end()) {
+      return base > limit - (int64_t)*hit ? -1 : base + *hit;
+    }
+    if (base > limit - (int64_t)pass_length) {
+      return -1;
+    }
+    node = lands[0][node];
+    base += (int64_t)pass_length;
+    // skip the largest blocks of passes without a goal
+    for (size_t level = lands.size(); level-- > 0;) {
+      if (first_goal[level][node] < 0) {
+        int64_t skipped = (int64_t)pass_length << level;
+        if (base > limit - skipped) {
+          return -1;
+        }
+        base += skipped;
+        node = lands[level][node];
+      }
+    }
+    int64_t goal = first_goal[0][node];
+    return goal < 0 || base > limit - goal ? -1 : base + goal;
   }
-  const int32_t LINE_CAPACITY = 1024 * 2;
-  char line[LINE_CAPACITY];
-  std::string directions;
-  if (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
-    directions = std::string(line, line_length);
-  }
-  std::map<std::string, std::pair<std::string, std::string>> nodes;
-  while (input.getline(line, LINE_CAPACITY)) {
-    size_t line_length = input.gcount() - 1;
-    if (line_length == 0)
+};
+// Passes are only walked from the nodes the starts can reach at a pass
+// boundary, so a table for a few walks costs about what the walks would.
+// Levels double up to max_passes; other nodes stay put and never hit a goal.
+// with_prefixes also records every pass walked, for position_after.
+Jumps build_jumps(const Network &network, std::vector<uint8_t> goals,
+                  const std::vector<uint16_t> &starts, int64_t max_passes, bool with_prefixes) {
+  Jumps jumps;
+  jumps.pass_length = network.turns.size();
+  jumps.goals = std::move(goals);
+  size_t nodes = network.size();
+  jumps.hits.resize(nodes);
+  jumps.lands.emplace_back(nodes);
+  jumps.first_goal.emplace_back(nodes, -1);
+  std::vector<uint8_t> walked(nodes, 0);
+  std::vector<uint16_t> reached;
+  for (size_t id = 0; id < nodes; ++id) {
+    jumps.lands[0][id] = (uint16_t)id;
+  }
+  if (with_prefixes) {
+    jumps.row.assign(nodes, -1);
+  }
+  std::vector<uint16_t> pending = starts;
+  while (!pending.empty()) {
+    uint16_t from = pending.back();
+    pending.pop_back();
+    if (walked[from]) {
       continue;
-    std::string node_name = std::string(line, 3);
-    std::string node_left = std::string(line + 7, 3);
-    std::string node_right = std::string(line + 12, 3);
-    nodes.insert(
-        {node_name,
-        {node_left, node_right}}
-    );
-  }
-  std::string start{"AAA"};
-  int32_t counter = 0;
-  int32_t direction_idx = 0;
-  while (start != "ZZZ") {
-    start = directions[direction_idx] == 'L' ? nodes[start].first : nodes[start].second;
-    direction_idx += 1;
-    direction_idx %= directions.size();
+    }
+    walked[from] = 1;
+    reached.push_back(from);
+    if (with_prefixes && jumps.prefix.size() + jumps.pass_length > max_prefix_entries) {
+      // too big to keep; position_after walks partial passes instead
+      with_prefixes = false;
+      jumps.prefix = {};
+    }
+    if (with_prefixes) {
+      jumps.row[from] = (int32_t)(jumps.prefix.size() / jumps.pass_length);
+    }
+    uint16_t node = from;
+    for (size_t idx = 0; idx < jumps.pass_length; ++idx) {
+      if (with_prefixes) {
+        jumps.prefix.push_back(node);
+      }
+      node = network.next[network.turns[idx]][node];
+      if (jumps.goals[node]) {
+        jumps.hits[from].push_back((uint32_t)(idx + 1));
+      }
+    }
+    jumps.lands[0][from] = node;
+    if (!jumps.hits[from].empty()) {
+      jumps.first_goal[0][from] = jumps.hits[from][0];
+    }
+    pending.push_back(node);
+  }
+  max_passes =
+      std::min(max_passes, std::numeric_limits<int64_t>::max() / (int64_t)jumps.pass_length);
+  for (size_t level = 1; (max_passes >> level) != 0; ++level) {
+    const std::vector<uint16_t> &half = jumps.lands[level - 1];
+    const std::vector<int64_t> &half_goal = jumps.first_goal[level - 1];
+    int64_t half_steps = (int64_t)jumps.pass_length << (level - 1);
+    std::vector<uint16_t> lands = half;
+    std::vector<int64_t> first_goal = half_goal;
+    for (uint16_t id : reached) {
+      uint16_t middle = half[id];
+      lands[id] = half[middle];
+      first_goal[id] = half_goal[id] >= 0       ? half_goal[id]
+                       : half_goal[middle] >= 0 ? half_steps + half_goal[middle]
+                                                : -1;
+    }
+    jumps.lands.push_back(std::move(lands));
+    jumps.first_goal.push_back(std::move(first_goal));
+  }
+  return jumps;
+}
+// the nodes whose name ends in end
+std::vector<uint8_t> nodes_ending_in(const Network &network, char end) {
+  std::vector<uint8_t> goals(network.size());
+  for (size_t id = 0; id < network.size(); ++id) {
+    goals[id] = network.names[id][2] == end;
+  }
+  return goals;
+}
+
+int64_t part1(const Network &network) {
+  int32_t start = network.find("AAA");
+  int32_t goal = network.find("ZZZ");
+  if (start < 0 || goal < 0 || network.turns.empty()) {
+    return 0;
+  }
+  const uint8_t *turns = network.turns.data();
+  const uint16_t *next[2] = {network.next[0].data(), network.next[1].data()};
+  size_t turn_count = network.turns.size();
+  // past every (node, turn) pair the walk is going round a loop without ZZZ
+  int64_t limit = (int64_t)network.size() * (int64_t)turn_count;
+  uint16_t node = (uint16_t)start;
+  int64_t counter = 0;
+  size_t direction_idx = 0;
+  while (node != goal) {
+    if (counter > limit) {
+      throw std::runtime_error("ZZZ cannot be reached from AAA");
+    }
+    node = next[turns[direction_idx]][node];
+    if (++direction_idx == turn_count) {
+      direction_idx = 0;
+    }
     counter += 1;
   }
-  std::cout << "PART1: " << counter << std::endl;
+  return counter;
+}
+// Where one ghost stands on a Z node. At the start of a pass the state is
+// just the node, so the walk is a tail of cycle_start steps and then a loop
+// of cycle_length, both whole passes. z_hits lists every step in
+// [0, cycle_start + cycle_length) on a Z node.
+struct Ghost {
+  std::vector<int64_t> z_hits;
+  int64_t cycle_start = 0;
+  int64_t cycle_length = 0;
+  bool at_z(int64_t step) const {
+    if (step >= cycle_start) {
+      step = cycle_start + (step - cycle_start) % cycle_length;
+    }
+    return std::binary_search(z_hits.begin(), z_hits.end(), step);
+  }
+};
+// seen[node] is the pass a walk first started from node at, -1 if not yet;
+// every entry this walk sets is put back afterwards.
+Ghost trace_ghost(const Jumps &jumps, uint16_t node, std::vector<int64_t> &seen) {
+  int64_t pass_length = (int64_t)jumps.pass_length;
+  Ghost ghost;
+  std::vector<uint16_t> touched;
+  if (jumps.goals[node]) {
+    ghost.z_hits.push_back(0);
+  }
+  for (int64_t pass = 0;; ++pass) {
+    if (seen[node] >= 0) {
+      ghost.cycle_start = seen[node] * pass_length;
+      ghost.cycle_length = (pass - seen[node]) * pass_length;
+      break;
+    }
+    seen[node] = pass;
+    touched.push_back(node);
+    for (uint32_t hit : jumps.hits[node]) {
+      ghost.z_hits.push_back(pass * pass_length + hit);
+    }
+    node = jumps.lands[0][node];
+  }
+  // a hit that ends the last pass is the first step of the cycle again
+  while (!ghost.z_hits.empty() && ghost.z_hits.back() >= ghost.cycle_start + ghost.cycle_length) {
+    ghost.z_hits.pop_back();
+  }
+  for (uint16_t id : touched) {
+    seen[id] = -1;
+  }
+  return ghost;
+}
 
-  std::vector<std::string_view> a_nodes;
-  for (auto &p : nodes) {
-    const std::string& node_name = p.first;
-    switch (node_name[2]) {
-      case 'A': a_nodes.push_back(std::string_view{node_name}); break;
-      default: break;
-    }
-  }
-  std::map<std::string, int64_t> history;
-  for (size_t idx = 0; idx < a_nodes.size(); ++idx) {
-    std::set<std::string> cycle_detect;
-    auto curr_str = std::string(a_nodes[idx]);
-    int32_t idx_direction = 0;
-    std::string key_check = 
-      curr_str +
-      std::string{directions[idx_direction]} +
-      std::to_string(idx_direction);
-    int64_t counter = 0;
-    int64_t high_z = 0;
-    while (!cycle_detect.contains(key_check)) {
-      const std::string key =
-        curr_str +
-        std::string{directions[idx_direction]} +
-        std::to_string(idx_direction);
-      cycle_detect.insert(key);
-      curr_str = directions[idx_direction] == 'L' ? nodes[curr_str].first : nodes[curr_str].second;
-      if (curr_str[2] == 'Z') {
-        high_z = counter + 1;
-      }
-      idx_direction += 1;
-      idx_direction %= directions.size();
-      counter += 1;
-      key_check = curr_str + std::string{directions[idx_direction]} + std::to_string(idx_direction);
-    }
-    history.insert({std::string(a_nodes[idx]), high_z});
-  }
-  int64_t curr_lcm = 1;
-  for (auto p : history) {
-    curr_lcm = std::lcm(curr_lcm, p.second);
-  }
-  std::cout << "PART2: " << curr_lcm << std::endl;
+__extension__ typedef __int128 i128;
+// x = one of residues (mod modulus)
+struct Congruence {
+  std::vector<i128> residues;
+  i128 modulus = 1;
+};
+// std::gcd only takes standard integer types
+i128 gcd(i128 a, i128 b) {
+  while (b != 0) {
+    a %= b;
+    std::swap(a, b);
+  }
+  return a;
+}
+// a^-1 mod m for gcd(a, m) == 1
+i128 mod_inverse(i128 a, i128 m) {
+  i128 old_r = a % m, r = m, old_s = 1, s = 0;
+  while (r != 0) {
+    i128 q = old_r / r;
+    old_r -= q * r;
+    std::swap(old_r, r);
+    old_s -= q * s;
+    std::swap(old_s, s);
+  }
+  return ((old_s % m) + m) % m;
+}
+// More residues than this are not merged; 2^22 of them take 64 MiB.
+constexpr size_t max_residues = 1 << 22;
+// The CRT for moduli that need not be coprime: every pair of residues that
+// agrees mod gcd(m, n) becomes one residue mod lcm(m, n). Both moduli stay
+// below 2^63, so everything fits in 128 bits. False, with result left
+// partly filled, if there would be more than max_residues.
+bool combine(const Congruence &a, const Congruence &b, Congruence &result) {
+  i128 g = gcd(a.modulus, b.modulus);
+  i128 n = b.modulus / g;
+  i128 inverse = mod_inverse(a.modulus / g % n, n);
+  result.modulus = a.modulus * n;
+  result.residues.clear();
+  for (i128 x : a.residues) {
+    for (i128 y : b.residues) {
+      if ((y - x) % g != 0) {
+        continue;
+      }
+      if (result.residues.size() == max_residues) {
+        return false;
+      }
+      i128 k = ((y - x) / g % n + n) % n * inverse % n;
+      result.residues.push_back(x + a.modulus * k);
+    }
+  }
+  std::sort(result.residues.begin(), result.residues.end());
+  return true;
+}
+// Drops every residue of a that no residue of b agrees with mod gcd of the
+// moduli: at those steps b's ghost is never on a Z node.
+void drop_unreachable(Congruence &a, const Congruence &b) {
+  i128 g = gcd(a.modulus, b.modulus);
+  std::vector<i128> allowed;
+  for (i128 y : b.residues) {
+    allowed.push_back(y % g);
+  }
+  std::sort(allowed.begin(), allowed.end());
+  std::erase_if(a.residues,
+                [&](i128 x) { return !std::binary_search(allowed.begin(), allowed.end(), x % g); });
+}
+
+constexpr int64_t max_checks = int64_t(1) << 26;
+// The first step from max(tail, 1) on that is one of merged's residues and
+// has every ghost in rest on a Z node, trying at most max_checks steps.
+// merged.modulus is at most INT64_MAX; -1 if no step up to it qualifies.
+int64_t first_candidate_at_z(const Congruence &merged, const std::vector<Ghost> &ghosts,
+                             const std::vector<size_t> &rest, int64_t tail) {
+  constexpr i128 limit = std::numeric_limits<int64_t>::max();
+  i128 from = std::max<int64_t>(tail, 1);
+  int64_t checks = 0;
+  if (merged.residues.empty()) {
+    return -1;
+  }
+  for (i128 base = from / merged.modulus * merged.modulus; base <= limit;
+       base += merged.modulus) {
+    for (i128 residue : merged.residues) {
+      i128 step = base + residue;
+      if (step < from) {
+        continue;
+      }
+      if (step > limit) {
+        return -1;
+      }
+      if (++checks > max_checks) {
+        throw std::runtime_error("the ghosts have too many Z step patterns to search");
+      }
+      if (std::all_of(rest.begin(), rest.end(),
+                      [&](size_t ghost) { return ghosts[ghost].at_z((int64_t)step); })) {
+        return (int64_t)step;
+      }
+    }
+  }
+  return -1;
+}
+
+// The first step every ghost is on a Z node at once. Steps before the last
+// cycle starts are checked one Z hit at a time; after it, each ghost is a
+// set of residues mod its cycle length, and the CRT merges them all, the
+// ghosts with the fewest residues first and every merged residue that one of
+// the remaining ghosts rules out dropped straight away.
+int64_t first_common_z(const std::vector<Ghost> &ghosts) {
+  if (ghosts.empty()) {
+    return 0;
+  }
+  const Ghost &latest = *std::max_element(
+      ghosts.begin(), ghosts.end(),
+      [](const Ghost &a, const Ghost &b) { return a.cycle_start < b.cycle_start; });
+  int64_t tail = latest.cycle_start;
+  for (int64_t step : latest.z_hits) {
+    if (step > 0 && step < tail &&
+        std::all_of(ghosts.begin(), ghosts.end(),
+                    [step](const Ghost &ghost) { return ghost.at_z(step); })) {
+      return step;
+    }
+  }
+  std::vector<Congruence> cycles(ghosts.size());
+  for (size_t idx = 0; idx < ghosts.size(); ++idx) {
+    const Ghost &ghost = ghosts[idx];
+    cycles[idx].modulus = ghost.cycle_length;
+    for (int64_t step : ghost.z_hits) {
+      if (step >= ghost.cycle_start) {
+        cycles[idx].residues.push_back(step % ghost.cycle_length);
+      }
+    }
+    std::sort(cycles[idx].residues.begin(), cycles[idx].residues.end());
+  }
+  for (Congruence &cycle : cycles) {
+    for (const Congruence &other : cycles) {
+      drop_unreachable(cycle, other);
+    }
+  }
+  std::vector<size_t> order(ghosts.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return cycles[a].residues.size() < cycles[b].residues.size();
+  });
+  constexpr i128 limit = std::numeric_limits<int64_t>::max();
+  Congruence merged;
+  merged.residues.push_back(0);
+  for (size_t idx = 0; idx < order.size() && !merged.residues.empty(); ++idx) {
+    Congruence next;
+    if (!combine(merged, cycles[order[idx]], next)) {
+      int64_t step = first_candidate_at_z(merged, ghosts,
+                                          {order.begin() + (ptrdiff_t)idx, order.end()}, tail);
+      if (step < 0) {
+        throw std::overflow_error("the ghosts do not meet on Z nodes within int64_t steps");
+      }
+      return step;
+    }
+    merged = std::move(next);
+    for (size_t rest = idx + 1; rest < order.size(); ++rest) {
+      drop_unreachable(merged, cycles[order[rest]]);
+    }
+    if (merged.modulus > limit) {
+      // only the residues themselves are small enough to be the answer, so
+      // the rest of the ghosts are checked against them directly
+      for (i128 step : merged.residues) {
+        if (step >= tail && step > 0 && step <= limit &&
+            std::all_of(order.begin() + (ptrdiff_t)idx + 1, order.end(),
+                        [&](size_t ghost) { return ghosts[ghost].at_z((int64_t)step); })) {
+          return (int64_t)step;
+        }
+      }
+      throw std::overflow_error("the ghosts do not meet on Z nodes within int64_t steps");
+    }
+  }
+  i128 best = -1;
+  for (i128 step : merged.residues) {
+    if (step < tail || step == 0) {
+      i128 behind = std::max<i128>(tail, 1) - step;
+      step += (behind + merged.modulus - 1) / merged.modulus * merged.modulus;
+    }
+    if (best < 0 || step < best) {
+      best = step;
+    }
+  }
+  if (best < 0) {
+    throw std::runtime_error("the ghosts are never all on Z nodes at once");
+  }
+  if (best > limit) {
+    throw std::overflow_error("the ghosts do not meet on Z nodes within int64_t steps");
+  }
+  return (int64_t)best;
+}
+int64_t part2(const Network &network) {
+  if (network.turns.empty()) {
+    return 0;
+  }
+  std::vector<uint16_t> starts;
+  for (size_t id = 0; id < network.size(); ++id) {
+    if (network.names[id][2] == 'A') {
+      starts.push_back((uint16_t)id);
+    }
+  }
+  // tracing a ghost only follows single passes
+  Jumps jumps = build_jumps(network, nodes_ending_in(network, 'Z'), starts, 1, false);
+  std::vector<int64_t> seen(network.size(), -1);
+  std::vector<Ghost> ghosts;
+  for (uint16_t start : starts) {
+    ghosts.push_back(trace_ghost(jumps, start, seen));
+  }
+  return first_common_z(ghosts);
+}
+// ./day8 input.txt [--from NAME] [--at K] [--next-z S] ...
+// for every ghost (or each one named) prints "NAME at K NODE" with the node
+// K steps in and "NAME next-z S STEP" with the first step after S on a Z
+// node, -1 if there is none
+int32_t walk(const char *path, const std::vector<std::string_view> &args) {
+  InputFile input(path);
+  if (!input.is_open()) {
+    std::cerr << path << " file cannot be opened\n";
+    return 1;
+  }
+  Network network = parse(input.contents());
+  if (network.turns.empty()) {
+    std::cerr << "no instructions\n";
+    return 1;
+  }
+  std::vector<uint16_t> starts;
+  std::vector<std::pair<std::string_view, int64_t>> queries;
+  for (size_t idx = 0; idx < args.size(); ++idx) {
+    bool has_value = idx + 1 < args.size();
+    if (args[idx] == "--from" && has_value) {
+      int32_t id = network.find(args[++idx]);
+      if (id < 0) {
+        std::cerr << "no node " << args[idx] << "\n";
+        return 1;
+      }
+      starts.push_back((uint16_t)id);
+    } else if ((args[idx] == "--at" || args[idx] == "--next-z") && has_value &&
+               !args[idx + 1].empty() &&
+               std::all_of(args[idx + 1].begin(), args[idx + 1].end(), is_digit)) {
+      queries.push_back({args[idx].substr(2), parse_number(args[idx + 1])});
+      ++idx;
+    } else {
+      std::cerr << "day8 options: --from NAME --at K --next-z S\n";
+      return 1;
+    }
+  }
+  if (starts.empty()) {
+    for (size_t id = 0; id < network.size(); ++id) {
+      if (network.names[id][2] == 'A') {
+        starts.push_back((uint16_t)id);
+      }
+    }
+  }
+  Jumps jumps = build_jumps(network, nodes_ending_in(network, 'Z'), starts,
+                            std::numeric_limits<int64_t>::max(), true);
+  for (uint16_t start : starts) {
+    std::string_view name(network.names[start].data(), 3);
+    for (const auto &[query, steps] : queries) {
+      std::cout << name << " " << query << " " << steps << " ";
+      if (query == "at") {
+        uint16_t node = jumps.position_after(start, steps, network);
+        std::cout << std::string_view(network.names[node].data(), 3) << "\n";
+      } else {
+        std::cout << jumps.next_goal(start, steps, network) << "\n";
+      }
+    }
+  }
   return 0;
 }
+} // namespace day8
+AOC_DAY_COMMAND(8, parse, part1, part2, walk)
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../common/harness.h"
+#include "../common/input.h"
+#include "../common/pool.h"
+// Every day linked into one binary. Runs a batch of (day, input) jobs on the
+// work-stealing pool from common/pool.h and prints the answers in the order
+// the jobs were given.
+//   ./aoc_runner [-j threads] <day>:<input> ...
+//   ./aoc_runner [-j threads] --jobs list.txt      one "<day> <input>" per line
+// The largest inputs start first so the slowest jobs are not left for the
+// end. Parse, part1 and part2 are separate tasks, and days that split their
+// own work (day13, day16) submit it to the same pool.
+struct Job {
+  int32_t day = 0;
+  std::string path;
+  const Day *solver = nullptr;
+  std::string part1;
+  std::string part2;
+  std::string error;
+  int64_t nanoseconds = 0;
+};
+
+void run_job(Job &job) {
+  auto start = std::chrono::steady_clock::now();
+  InputFile input(job.path.c_str());
+  if (!input.is_open()) {
+    job.error = "file cannot be opened";
+    return;
+  }
+  // the parsed input may point into the mapped file, which lives until here
+  std::shared_ptr<const void> parsed = job.solver->parse(input.contents());
+  TaskGroup parts;
+  parts.run([&] { job.part1 = answer_text(job.solver->part1, parsed.get()); });
+  parts.run([&] { job.part2 = answer_text(job.solver->part2, parsed.get()); });
+  parts.wait();
+  job.nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+          .count();
+}
+
+bool add_job(std::vector<Job> &jobs, int32_t day, std::string path) {
+  if (day < 1 || path.empty()) {
+    return false;
+  }
+  Job &job = jobs.emplace_back();
+  job.day = day;
+  job.path = std::move(path);
+  return true;
+}
+
+int32_t usage(const char *program) {
+  std::cerr << "usage: " << program << " [-j threads] <day>:<input> ...\n"
+            << "       " << program << " [-j threads] --jobs list.txt\n";
+  return 1;
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  std::vector<Job> jobs;
+  for (int32_t idx = 1; idx < argc; ++idx) {
+    std::string arg = argv[idx];
+    if (arg == "-j" && idx + 1 < argc) {
+      set_pool_threads((size_t)std::max(1, std::atoi(argv[++idx])));
+    } else if (arg == "--jobs" && idx + 1 < argc) {
+      std::ifstream list(argv[++idx]);
+      if (!list.is_open()) {
+        std::cerr << argv[idx] << " file cannot be opened\n";
+        return 1;
+      }
+      int32_t day;
+      std::string path;
+      while (list >> day >> path) {
+        add_job(jobs, day, path);
+      }
+    } else {
+      size_t colon = arg.find(':');
+      if (colon == std::string::npos ||
+          !add_job(jobs, std::atoi(arg.substr(0, colon).c_str()), arg.substr(colon + 1))) {
+        return usage(argv[0]);
+      }
+    }
+  }
+  if (jobs.empty()) {
+    return usage(argv[0]);
+  }
+
+  std::map<int32_t, const Day *> days;
+  for (const Day &day : registered_days()) {
+    days[day.number] = &day;
+  }
+  std::vector<size_t> order;
+  std::vector<uintmax_t> sizes(jobs.size(), 0);
+  for (size_t idx = 0; idx < jobs.size(); ++idx) {
+    Job &job = jobs[idx];
+    if (!days.contains(job.day)) {
+      job.error = "day" + std::to_string(job.day) + " is not built into this runner";
+      continue;
+    }
+    job.solver = days[job.day];
+    std::error_code ec;
+    sizes[idx] = std::filesystem::file_size(job.path, ec);
+    order.push_back(idx);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  auto start = std::chrono::steady_clock::now();
+  TaskGroup batch;
+  for (size_t idx : order) {
+    batch.run([&job = jobs[idx]] {
+      try {
+        run_job(job);
+      } catch (const std::exception &e) {
+        job.error = e.what();
+      } catch (...) {
+        job.error = "unknown exception";
+      }
+    });
+  }
+  batch.wait();
+  int64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+  int32_t failed = 0;
+  int64_t total = 0;
+  for (const Job &job : jobs) {
+    std::cout << "day" << job.day << " " << job.path << " ";
+    if (!job.error.empty()) {
+      std::cout << "ERROR: " << job.error << "\n";
+      ++failed;
+      continue;
+    }
+    char ms[32];
+    std::snprintf(ms, sizeof(ms), "%.1f", (double)job.nanoseconds / 1e6);
+    std::cout << "PART1: " << job.part1 << " PART2: " << job.part2 << " (" << ms << " ms)\n";
+    total += job.nanoseconds;
+  }
+  char summary[128];
+  std::snprintf(summary, sizeof(summary),
+                "%zu jobs on %zu threads: %.1f ms wall, %.1f ms summed over jobs\n", jobs.size(),
+                pool().size(), (double)wall / 1e6, (double)total / 1e6);
+  std::cout << summary;
+  return failed == 0 ? 0 : 1;
+}